@@ -17,6 +17,10 @@ std::string toString(CameraCalibrationStatus status)
 			return "ImageAccepted";
 		case RCamera::CameraCalibrationStatus::ImageRejected:
 			return "ImageRejected";
+		case RCamera::CameraCalibrationStatus::ImageBlurred:
+			return "ImageBlurred";
+		case RCamera::CameraCalibrationStatus::ImageOverexposed:
+			return "ImageOverexposed";
 		case RCamera::CameraCalibrationStatus::Calibrated:
 			return "Calibrated";
 		case RCamera::CameraCalibrationStatus::CalibrationFailed:
@@ -18,12 +18,26 @@ enum class CameraCalibrationStatus
 	ImageSizeInvalid,
 	ImageAccepted,
 	ImageRejected,
+	ImageBlurred,
+	ImageOverexposed,
 	Calibrated,
 	CalibrationFailed
 };
 
 std::string toString(CameraCalibrationStatus status);
 
+NLOHMANN_JSON_SERIALIZE_ENUM(CameraCalibrationStatus,
+{
+	{CameraCalibrationStatus::InvalidBytesPerPixel, "InvalidBytesPerPixel"},
+	{CameraCalibrationStatus::ImageSizeInvalid    , "ImageSizeInvalid"},
+	{CameraCalibrationStatus::ImageAccepted       , "ImageAccepted"},
+	{CameraCalibrationStatus::ImageRejected       , "ImageRejected"},
+	{CameraCalibrationStatus::ImageBlurred        , "ImageBlurred"},
+	{CameraCalibrationStatus::ImageOverexposed    , "ImageOverexposed"},
+	{CameraCalibrationStatus::Calibrated          , "Calibrated"},
+	{CameraCalibrationStatus::CalibrationFailed   , "CalibrationFailed"}
+})
+
 
 // The AbstractCameraCalibrator calibrates intrinsic and extrinsic parameters of a camera from a set of images.
 class AbstractCameraCalibrator
@@ -0,0 +1,397 @@
+
+#include "CalibrationBenchmark.h"
+#include "CameraCalibratorHelper.h"
+#include "SparseCalibrationSolver.h"
+
+#include "fmt/format.h"
+#include "opencv2/calib3d.hpp"
+#include "opencv2/imgproc.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+
+namespace RCamera {
+;
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+CalibrationBenchmark::CalibrationBenchmark(const CalibratorConfiguration& configuration)
+	: mConfiguration(configuration)
+{
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// The chessboard is drawn on a flat texture and warped into the image with a random homography. The true corner 
+// positions are the texture corners transformed by the same homography.
+void CalibrationBenchmark::createImages(int numImages, const cv::Size& imageSize, double noiseSigma, unsigned int seed)
+{
+	const int _boardWidth  = mConfiguration.boardWidth();
+	const int _boardHeight = mConfiguration.boardHeight();
+	const int _squareSize  = 40;
+	const int _margin      = _squareSize; // White border around the squares, required by the detectors.
+
+	cv::Mat _texture((_boardHeight+1) * _squareSize + 2*_margin, (_boardWidth+1) * _squareSize + 2*_margin, CV_8UC1, cv::Scalar(255));
+	for(int i = 0 ; i<=_boardHeight ; ++i)
+	{
+		for(int j = 0 ; j<=_boardWidth ; ++j)
+		{
+			if((i + j) % 2 == 0)
+			{
+				_texture(cv::Rect(_margin + j*_squareSize, _margin + i*_squareSize, _squareSize, _squareSize)).setTo(0);
+			}
+		}
+	}
+
+	// Pixel centres are at integer coordinates, so the edges between pixels are at -0.5.
+	std::vector<cv::Point2f> _textureCorners;
+	for(int i = 0 ; i<_boardHeight ; ++i)
+	{
+		for(int j = 0 ; j<_boardWidth ; ++j)
+		{
+			_textureCorners.emplace_back(float(_margin + (j+1)*_squareSize) - 0.5f, float(_margin + (i+1)*_squareSize) - 0.5f);
+		}
+	}
+	const float                    _textureWidth  = float(_texture.cols);
+	const float                    _textureHeight = float(_texture.rows);
+	const std::vector<cv::Point2f> _textureOutline{{-0.5f, -0.5f}, {_textureWidth - 0.5f, -0.5f}, {_textureWidth - 0.5f, _textureHeight - 0.5f}, {-0.5f, _textureHeight - 0.5f}};
+
+	cv::RNG _rng(seed);
+	mImages.clear();
+	while(int(mImages.size()) < numImages)
+	{
+		// Random scale, rotation and position, followed by a random perspective distortion of the outline.
+		const double _scale    = _rng.uniform(0.35, 0.7) * imageSize.width / _textureWidth;
+		const double _angle    = _rng.uniform(-0.5, 0.5);
+		const double _centerX  = _rng.uniform(0.3, 0.7) * imageSize.width;
+		const double _centerY  = _rng.uniform(0.3, 0.7) * imageSize.height;
+		const double _jitter   = 0.08 * _scale * _textureWidth;
+
+		std::vector<cv::Point2f> _imageOutline;
+		bool                     _isInside = true;
+		for(const auto& p : _textureOutline)
+		{
+			const double _x = _scale * (p.x - 0.5*_textureWidth);
+			const double _y = _scale * (p.y - 0.5*_textureHeight);
+			cv::Point2f  _q(float(_centerX + std::cos(_angle)*_x - std::sin(_angle)*_y + _rng.uniform(-_jitter, _jitter)),
+			                float(_centerY + std::sin(_angle)*_x + std::cos(_angle)*_y + _rng.uniform(-_jitter, _jitter)));
+			_isInside = _isInside && _q.x > 2 && _q.y > 2 && _q.x < imageSize.width - 3 && _q.y < imageSize.height - 3;
+			_imageOutline.push_back(_q);
+		}
+		if(!_isInside)
+		{
+			continue;
+		}
+
+		const cv::Mat _homography = cv::getPerspectiveTransform(_textureOutline, _imageOutline);
+
+		SyntheticChessboardImage _image;
+		cv::warpPerspective(_texture, _image.image, _homography, imageSize, cv::INTER_AREA, cv::BORDER_CONSTANT, cv::Scalar(128));
+		cv::perspectiveTransform(_textureCorners, _image.corners, _homography);
+
+		// Lens blur and sensor noise.
+		cv::GaussianBlur(_image.image, _image.image, cv::Size(5, 5), 1.0);
+		cv::Mat _noise(imageSize, CV_32FC1);
+		_rng.fill(_noise, cv::RNG::NORMAL, 0.0, noiseSigma);
+		cv::Mat _noisyImage;
+		_image.image.convertTo(_noisyImage, CV_32FC1);
+		_noisyImage += _noise;
+		_noisyImage.convertTo(_image.image, CV_8UC1);
+
+		mImages.push_back(std::move(_image));
+	}
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+nlohmann::json CalibrationBenchmark::benchmarkDetectorBackends() const
+{
+	struct Detector
+	{
+		std::string     name;
+		DetectorBackend backend;
+		bool            exhaustive;
+		bool            accuracy;
+		bool            larger;
+	};
+	const std::vector<Detector> _detectors{
+		{"Classic"                        , DetectorBackend::Classic    , false, false, false},
+		{"SectorBased"                    , DetectorBackend::SectorBased, false, false, false},
+		{"SectorBased Exhaustive"         , DetectorBackend::SectorBased, true , false, false},
+		{"SectorBased Accuracy"           , DetectorBackend::SectorBased, false, true , false},
+		{"SectorBased Exhaustive Accuracy", DetectorBackend::SectorBased, true , true , false},
+		{"SectorBased Larger"             , DetectorBackend::SectorBased, false, false, true }};
+
+	nlohmann::json _results = nlohmann::json::array();
+	for(const Detector& d : _detectors)
+	{
+		CalibratorConfiguration _configuration = mConfiguration;
+		_configuration.setDetectorBackend(d.backend);
+		_configuration.setDetectorExhaustive(d.exhaustive);
+		_configuration.setDetectorAccuracy(d.accuracy);
+		_configuration.setDetectorLarger(d.larger);
+		_configuration.setDetectionCacheDirectory("");
+		_results.push_back(_benchmarkDetector(d.name, _configuration));
+	}
+	return _results;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+nlohmann::json CalibrationBenchmark::_benchmarkDetector(const std::string& name, const CalibratorConfiguration& configuration) const
+{
+	const CameraCalibratorHelper _helper(configuration);
+
+	int    _numDetected     = 0;
+	double _sumSquaredError = 0;
+	double _totalTimeMS     = 0;
+	for(const SyntheticChessboardImage& _image : mImages)
+	{
+		auto _startTime = std::chrono::high_resolution_clock::now();
+		const std::vector<cv::Point2f> _corners = _helper.findChessboardCorners(_image.image);
+		auto _endTime   = std::chrono::high_resolution_clock::now();
+		_totalTimeMS += std::chrono::duration<double, std::milli>(_endTime - _startTime).count();
+
+		if(!_corners.empty())
+		{
+			const double _rmsError = _cornerRmsError(_corners, _image.corners);
+			_sumSquaredError += _rmsError * _rmsError;
+			++_numDetected;
+		}
+	}
+
+	const int    _numImages       = int(mImages.size());
+	const double _imagesPerSecond = _totalTimeMS > 0 ? 1000.0 * _numImages / _totalTimeMS : 0.0;
+	const double _detectionRate   = _numImages > 0 ? double(_numDetected) / _numImages : 0.0;
+	const double _rmsError        = _numDetected > 0 ? std::sqrt(_sumSquaredError / _numDetected) : 0.0;
+	std::cout << fmt::format("{:<32} {:8.2f} images/s, detected {:3}/{:3}, corner RMS {:.4f} px\n", 
+	                         name, _imagesPerSecond, _numDetected, _numImages, _rmsError);
+
+	nlohmann::json _result;
+	_result["Name"]            = name;
+	_result["Backend"]         = configuration.detectorBackend();
+	_result["Exhaustive"]      = configuration.detectorExhaustive();
+	_result["Accuracy"]        = configuration.detectorAccuracy();
+	_result["Larger"]          = configuration.detectorLarger();
+	_result["NumImages"]       = _numImages;
+	_result["NumDetected"]     = _numDetected;
+	_result["DetectionRate"]   = _detectionRate;
+	_result["ImagesPerSecond"] = _imagesPerSecond;
+	_result["CornerRmsError"]  = _rmsError;
+	return _result;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Calibrate synthetic views of the board with both solvers. cv::calibrateCamera solves a dense system over all 
+// extrinsics, which becomes impractical with many views, so it is only run up to maxOpenCVViews.
+nlohmann::json CalibrationBenchmark::benchmarkCalibrationSolvers(const std::vector<int>& numViews, int maxOpenCVViews) const
+{
+	const cv::Size    _imageSize(1280, 960);
+	const cv::Matx33d _cameraMatrix(1000, 0, 645, 0, 1000, 475, 0, 0, 1);
+	const cv::Mat     _distortionCoeffs = (cv::Mat_<double>(5, 1) << -0.15, 0.05, 0.0005, -0.0005, 0);
+	const int         _calibrationFlag  = mConfiguration.calibrationFlag();
+
+	nlohmann::json _results = nlohmann::json::array();
+	for(int n : numViews)
+	{
+		std::vector<std::vector<cv::Point3f>> _objectPoints;
+		std::vector<std::vector<cv::Point2f>> _imagePoints;
+		_createViews(n, _imageSize, _cameraMatrix, _distortionCoeffs, &_objectPoints, &_imagePoints);
+
+		nlohmann::json _result;
+		_result["NumViews"] = n;
+		for(CalibrationSolver _solver : {CalibrationSolver::OpenCV, CalibrationSolver::SparseLM})
+		{
+			if(_solver == CalibrationSolver::OpenCV && n > maxOpenCVViews)
+			{
+				continue;
+			}
+
+			CameraCalibratorHelper _helper(mConfiguration);
+			_helper.initializeCameraParameters();
+			std::vector<cv::Mat>   _rotationVectors;
+			std::vector<cv::Mat>   _translationVectors;
+			const cv::TermCriteria _criteria(cv::TermCriteria::COUNT + cv::TermCriteria::EPS, 30, DBL_EPSILON);
+			int                    _numIterations = 0;
+			double                 _rmsError      = 0;
+
+			auto _startTime = std::chrono::high_resolution_clock::now();
+			if(_solver == CalibrationSolver::SparseLM)
+			{
+				SparseCalibrationSolver _sparseSolver(_calibrationFlag, _criteria);
+				_rmsError      = _sparseSolver.calibrate(_objectPoints, _imagePoints, _imageSize, _helper.mIntrinsicMatrix, _helper.mDistortionCoeffs, 
+				                                         _rotationVectors, _translationVectors);
+				_numIterations = _sparseSolver.numIterations();
+			}
+			else
+			{
+				_rmsError = cv::calibrateCamera(_objectPoints, _imagePoints, _imageSize, _helper.mIntrinsicMatrix, _helper.mDistortionCoeffs, 
+				                                _rotationVectors, _translationVectors, _calibrationFlag, _criteria);
+			}
+			auto _endTime = std::chrono::high_resolution_clock::now();
+			const double _timeMS = std::chrono::duration<double, std::milli>(_endTime - _startTime).count();
+
+			const cv::Matx33d _estimated(_helper.mIntrinsicMatrix);
+			const double      _focalLengthError    = std::max(std::abs(_estimated(0, 0) - _cameraMatrix(0, 0)), std::abs(_estimated(1, 1) - _cameraMatrix(1, 1)));
+			const double      _principalPointError = std::max(std::abs(_estimated(0, 2) - _cameraMatrix(0, 2)), std::abs(_estimated(1, 2) - _cameraMatrix(1, 2)));
+
+			const std::string _name = nlohmann::json(_solver).get<std::string>();
+			std::cout << fmt::format("{:4} views {:<8} {:10.1f} ms, RMS {:.4f} px, focal length error {:.3f} px, principal point error {:.3f} px\n", 
+			                         n, _name, _timeMS, _rmsError, _focalLengthError, _principalPointError);
+
+			_result[_name]["TimeMS"]              = _timeMS;
+			_result[_name]["RmsError"]            = _rmsError;
+			_result[_name]["FocalLengthError"]    = _focalLengthError;
+			_result[_name]["PrincipalPointError"] = _principalPointError;
+			if(_solver == CalibrationSolver::SparseLM)
+			{
+				_result[_name]["NumIterations"] = _numIterations;
+			}
+		}
+		_results.push_back(_result);
+	}
+	return _results;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Compare the single pass display kernel with the sequence of OpenCV calls it replaces. Half of the tint mask is 
+// covered, as it is during calibration, and the outputs are checked to be identical.
+nlohmann::json CalibrationBenchmark::benchmarkDisplayImage(const std::vector<cv::Size>& imageSizes, int numRepetitions) const
+{
+	auto _previousDisplayImage = [](const cv::Mat& grayImage, const cv::Mat& tint, cv::Mat* rgbImage)
+	{
+		cv::cvtColor(grayImage, *rgbImage, cv::COLOR_GRAY2RGB);
+
+		cv::Mat _redChannel;
+		cv::extractChannel(*rgbImage, _redChannel, 0);
+		cv::add(_redChannel, tint, _redChannel);
+		cv::insertChannel(_redChannel, *rgbImage, 0);
+	};
+
+	nlohmann::json _results = nlohmann::json::array();
+	for(const cv::Size& _imageSize : imageSizes)
+	{
+		cv::Mat _grayImage(_imageSize, CV_8UC1);
+		cv::randu(_grayImage, cv::Scalar(0), cv::Scalar(256));
+		cv::Mat _tint(_imageSize, CV_8UC1, cv::Scalar(50));
+		_tint(cv::Rect(0, 0, _imageSize.width/2, _imageSize.height)).setTo(cv::Scalar(0));
+
+		// Both functions run once before timing, so the output buffers are allocated as in the calibrators.
+		cv::Mat _previousImage;
+		cv::Mat _fusedImage;
+		_previousDisplayImage(_grayImage, _tint, &_previousImage);
+		CameraCalibratorHelper::tintGrayImage(_grayImage, _tint, &_fusedImage);
+		const bool _isIdentical = cv::norm(_previousImage, _fusedImage, cv::NORM_INF) == 0;
+
+		auto _startTime = std::chrono::high_resolution_clock::now();
+		for(int i = 0 ; i<numRepetitions ; ++i)
+		{
+			_previousDisplayImage(_grayImage, _tint, &_previousImage);
+		}
+		auto _fusedStartTime = std::chrono::high_resolution_clock::now();
+		for(int i = 0 ; i<numRepetitions ; ++i)
+		{
+			CameraCalibratorHelper::tintGrayImage(_grayImage, _tint, &_fusedImage);
+		}
+		auto _endTime = std::chrono::high_resolution_clock::now();
+
+		const double _previousTimeMS = std::chrono::duration<double, std::milli>(_fusedStartTime - _startTime).count() / numRepetitions;
+		const double _fusedTimeMS    = std::chrono::duration<double, std::milli>(_endTime - _fusedStartTime).count() / numRepetitions;
+		const double _megapixels     = double(_imageSize.area()) * 1e-6;
+		std::cout << fmt::format("{:5.1f} MP ({}x{}) previous {:8.3f} ms, fused {:8.3f} ms, speedup {:.2f}x, identical {}\n", 
+		                         _megapixels, _imageSize.width, _imageSize.height, _previousTimeMS, _fusedTimeMS, _previousTimeMS / _fusedTimeMS, _isIdentical);
+
+		nlohmann::json _result;
+		_result["ImageWidth"]     = _imageSize.width;
+		_result["ImageHeight"]    = _imageSize.height;
+		_result["Megapixels"]     = _megapixels;
+		_result["PreviousTimeMS"] = _previousTimeMS;
+		_result["FusedTimeMS"]    = _fusedTimeMS;
+		_result["Speedup"]        = _previousTimeMS / _fusedTimeMS;
+		_result["Identical"]      = _isIdentical;
+		_results.push_back(_result);
+	}
+	return _results;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Project the board with random poses and add 0.1 pixel of corner noise. Views with corners outside the image are 
+// replaced, so every view sees the whole board.
+void CalibrationBenchmark::_createViews(int numViews, const cv::Size& imageSize, const cv::Matx33d& cameraMatrix, const cv::Mat& distortionCoeffs, 
+	                                    std::vector<std::vector<cv::Point3f>>* objectPoints, std::vector<std::vector<cv::Point2f>>* imagePoints) const
+{
+	const std::vector<cv::Point3f> _board       = CameraCalibratorHelper(mConfiguration).calculateChessboard3DCornerPositions();
+	const cv::Point3f              _boardCenter = 0.5f * (_board.front() + _board.back());
+	const double                   _boardSize   = cv::norm(_board.back() - _board.front());
+
+	cv::RNG _rng(1);
+	objectPoints->clear();
+	imagePoints->clear();
+	while(int(objectPoints->size()) < numViews)
+	{
+		// The board covers 25% to 60% of the image diagonal, tilted by up to 35 degrees.
+		const double _distance = cameraMatrix(0, 0) * _boardSize / (_rng.uniform(0.25, 0.6) * cv::norm(cv::Point(imageSize.width, imageSize.height)));
+		const cv::Vec3d _rotation(_rng.uniform(-0.6, 0.6), _rng.uniform(-0.6, 0.6), _rng.uniform(-0.3, 0.3));
+		cv::Matx33d     _R;
+		cv::Rodrigues(_rotation, _R);
+		const cv::Vec3d _translation = -(_R * cv::Vec3d(_boardCenter.x, _boardCenter.y, _boardCenter.z)) + 
+		                               cv::Vec3d(_rng.uniform(-0.3, 0.3) * _distance, _rng.uniform(-0.25, 0.25) * _distance, _distance);
+
+		std::vector<cv::Point2f> _projected;
+		cv::projectPoints(_board, _rotation, _translation, cameraMatrix, distortionCoeffs, _projected);
+
+		bool _isInside = true;
+		for(cv::Point2f& p : _projected)
+		{
+			p.x += float(_rng.gaussian(0.1));
+			p.y += float(_rng.gaussian(0.1));
+			_isInside = _isInside && p.x >= 0 && p.y >= 0 && p.x <= imageSize.width - 1 && p.y <= imageSize.height - 1;
+		}
+		if(_isInside)
+		{
+			objectPoints->push_back(_board);
+			imagePoints->push_back(_projected);
+		}
+	}
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// The detectors may start at either end of the board, so the error is computed for both orders.
+double CalibrationBenchmark::_cornerRmsError(const std::vector<cv::Point2f>& corners, const std::vector<cv::Point2f>& trueCorners)
+{
+	if(corners.size() != trueCorners.size() || corners.empty())
+	{
+		return std::numeric_limits<double>::max();
+	}
+
+	double _sumForward = 0;
+	double _sumReverse = 0;
+	const size_t _n = corners.size();
+	for(size_t i = 0 ; i<_n ; ++i)
+	{
+		const cv::Point2f _forward = corners[i] - trueCorners[i];
+		const cv::Point2f _reverse = corners[i] - trueCorners[_n - 1 - i];
+		_sumForward += _forward.dot(_forward);
+		_sumReverse += _reverse.dot(_reverse);
+	}
+	return std::sqrt(std::min(_sumForward, _sumReverse) / _n);
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+}; // end namespace RCamera
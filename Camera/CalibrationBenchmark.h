@@ -0,0 +1,57 @@
+
+#ifndef _RVISION_CAMERA_CALIBRATIONBENCHMARK_H_
+#define _RVISION_CAMERA_CALIBRATIONBENCHMARK_H_
+
+#include "CalibratorConfiguration.h"
+
+#include "nlohmann/json.hpp"
+#include "opencv2/core.hpp"
+
+#include <string>
+#include <vector>
+
+
+namespace RCamera {
+;
+
+// The SyntheticChessboardImage struct holds a rendered chessboard image and the true position of its inner corners.
+struct SyntheticChessboardImage
+{
+	cv::Mat                  image;   // The 8 bit grayscale image.
+	std::vector<cv::Point2f> corners; // The true corner positions, in the order returned by the detectors.
+};
+
+
+// The CalibrationBenchmark class measures the speed and accuracy of the calibration pipeline on synthetic images with 
+// known ground truth. The board size is taken from the configuration, all other settings are varied by the benchmark.
+class CalibrationBenchmark
+{
+public:
+
+	explicit CalibrationBenchmark(const CalibratorConfiguration& configuration);
+
+	void           createImages(int numImages, const cv::Size& imageSize, double noiseSigma = 2.0, unsigned int seed = 1);
+	nlohmann::json benchmarkDetectorBackends() const;
+	nlohmann::json benchmarkCalibrationSolvers(const std::vector<int>& numViews, int maxOpenCVViews = 200) const;
+	nlohmann::json benchmarkDisplayImage(const std::vector<cv::Size>& imageSizes, int numRepetitions = 20) const;
+
+	inline const std::vector<SyntheticChessboardImage>& images() const {return mImages;}
+
+
+private:
+
+	nlohmann::json _benchmarkDetector(const std::string& name, const CalibratorConfiguration& configuration) const;
+	static double  _cornerRmsError(const std::vector<cv::Point2f>& corners, const std::vector<cv::Point2f>& trueCorners);
+	void           _createViews(int numViews, const cv::Size& imageSize, const cv::Matx33d& cameraMatrix, const cv::Mat& distortionCoeffs, 
+	                            std::vector<std::vector<cv::Point3f>>* objectPoints, std::vector<std::vector<cv::Point2f>>* imagePoints) const;
+
+
+private:
+
+	CalibratorConfiguration               mConfiguration; // The configuration defining the board size.
+	std::vector<SyntheticChessboardImage> mImages;        // The images created by createImages().
+};
+
+}; // end namespace RCamera
+
+#endif // _RVISION_CAMERA_CALIBRATIONBENCHMARK_H_
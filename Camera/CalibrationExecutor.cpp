@@ -0,0 +1,84 @@
+
+#include "CalibrationExecutor.h"
+
+
+namespace RCamera {
+;
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+CalibrationExecutor::CalibrationExecutor()
+	: mIsRunning(false),
+	  mStop(false),
+	  mIsCancelled(false),
+	  mThread(&CalibrationExecutor::_run, this)
+{
+}
+CalibrationExecutor::~CalibrationExecutor()
+{
+	{
+		std::lock_guard<std::mutex> _lock(mMutex);
+		mStop        = true;
+		mPendingJob  = nullptr;
+		mIsCancelled = true;
+	}
+	mCondition.notify_all();
+	mThread.join();
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+void CalibrationExecutor::submit(Job job)
+{
+	{
+		std::lock_guard<std::mutex> _lock(mMutex);
+		mPendingJob = std::move(job);
+		if(mIsRunning)
+		{
+			mIsCancelled = true;
+		}
+	}
+	mCondition.notify_all();
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Block until all submitted jobs have finished.
+void CalibrationExecutor::wait()
+{
+	std::unique_lock<std::mutex> _lock(mMutex);
+	mCondition.wait(_lock, [this]() {return !mIsRunning && !mPendingJob;});
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+void CalibrationExecutor::_run()
+{
+	std::unique_lock<std::mutex> _lock(mMutex);
+	while(true)
+	{
+		mCondition.wait(_lock, [this]() {return mStop || mPendingJob;});
+		if(mStop)
+		{
+			break;
+		}
+
+		Job _job = std::move(mPendingJob);
+		mPendingJob  = nullptr;
+		mIsRunning   = true;
+		mIsCancelled = false;
+		_lock.unlock();
+
+		_job(mIsCancelled);
+
+		_lock.lock();
+		mIsRunning = false;
+		mCondition.notify_all();
+	}
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+}; // end namespace RCamera
@@ -0,0 +1,52 @@
+
+#ifndef _RVISION_CAMERA_CALIBRATIONEXECUTOR_H_
+#define _RVISION_CAMERA_CALIBRATIONEXECUTOR_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+
+namespace RCamera {
+;
+
+// The CalibrationExecutor class runs calibration jobs one at a time on a dedicated thread. Submitting a job while 
+// another job is running sets the cancel flag of the running job, and only the newest waiting job is kept, so the 
+// thread always moves on to the latest data.
+class CalibrationExecutor
+{
+public:
+
+	typedef std::function<void(const std::atomic<bool>& isCancelled)> Job;
+
+	CalibrationExecutor();
+	~CalibrationExecutor();
+
+	CalibrationExecutor(const CalibrationExecutor&)            = delete;
+	CalibrationExecutor& operator=(const CalibrationExecutor&) = delete;
+
+	void submit(Job job);
+	void wait();
+
+
+private:
+
+	void _run();
+
+
+private:
+
+	std::mutex              mMutex;
+	std::condition_variable mCondition;
+	Job                     mPendingJob;  // The next job to run, empty if none.
+	bool                    mIsRunning;   // True while a job runs.
+	bool                    mStop;        // Set by the destructor to end the thread.
+	std::atomic<bool>       mIsCancelled; // The cancel flag passed to the running job.
+	std::thread             mThread;      // Started last, after all other members are initialised.
+};
+
+}; // end namespace RCamera
+
+#endif // _RVISION_CAMERA_CALIBRATIONEXECUTOR_H_
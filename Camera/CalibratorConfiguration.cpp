@@ -33,7 +33,37 @@ CalibratorConfiguration::CalibratorConfiguration()
 	  mCalibFixK2(false),
 	  mCalibFixK3(false),
 	  mCalibFixK4(true),
-	  mCalibFixK5(true)
+	  mCalibFixK5(true),
+	  mNumDetectionThreads(0),
+	  mCornerRefinement(CornerRefinementMode::Redetect),
+	  mPyramidTargetWidth(0),
+	  mPyramidMinSquareSize(0),
+	  mTrackingMode(TrackingMode::None),
+	  mTrackingRoiMargin(0.25),
+	  mTrackingRedetectInterval(30),
+	  mDetectionCacheDirectory(""),
+	  mDetectorBackend(DetectorBackend::Classic),
+	  mDetectorExhaustive(false),
+	  mDetectorAccuracy(false),
+	  mDetectorLarger(false),
+	  mPrefilterImageWidth(320),
+	  mPrefilterMinSharpness(0),
+	  mPrefilterMaxSaturation(1),
+	  mCalibWarmStart(false),
+	  mCalibWarmStartTolerance(1e-5),
+	  mCalibrationSolver(CalibrationSolver::OpenCV),
+	  mCalibOutlierRejection(false),
+	  mCalibOutlierThreshold(3.0),
+	  mBootstrapSamples(0),
+	  mBootstrapConfidence(0.95),
+	  mViewSelectionSize(0),
+	  mBackgroundCalibration(false),
+	  mCameraModel(CameraModel::Pinhole),
+	  mStereoTwoPhase(false),
+	  mStereoRefineIntrinsics(false),
+	  mCoverageGridWidth(0),
+	  mCoverageGridHeight(0),
+	  mDisplayBufferPoolSize(4)
 {
 }
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
@@ -103,6 +133,36 @@ bool CalibratorConfiguration::loadConfiguration(const nlohmann::json& json, std:
 			mCalibFixK3                       = p["CalibFixK3"];
 			mCalibFixK4                       = p["CalibFixK4"];
 			mCalibFixK5                       = p["CalibFixK5"];
+			mNumDetectionThreads              = p.value("NumDetectionThreads", mNumDetectionThreads);
+			mCornerRefinement                 = p.value("CornerRefinement", mCornerRefinement);
+			mPyramidTargetWidth               = p.value("PyramidTargetWidth", mPyramidTargetWidth);
+			mPyramidMinSquareSize             = p.value("PyramidMinSquareSize", mPyramidMinSquareSize);
+			mTrackingMode                     = p.value("TrackingMode", mTrackingMode);
+			mTrackingRoiMargin                = p.value("TrackingRoiMargin", mTrackingRoiMargin);
+			mTrackingRedetectInterval         = p.value("TrackingRedetectInterval", mTrackingRedetectInterval);
+			mDetectionCacheDirectory          = p.value("DetectionCacheDirectory", mDetectionCacheDirectory);
+			mDetectorBackend                  = p.value("DetectorBackend", mDetectorBackend);
+			mDetectorExhaustive               = p.value("DetectorExhaustive", mDetectorExhaustive);
+			mDetectorAccuracy                 = p.value("DetectorAccuracy", mDetectorAccuracy);
+			mDetectorLarger                   = p.value("DetectorLarger", mDetectorLarger);
+			mPrefilterImageWidth              = p.value("PrefilterImageWidth", mPrefilterImageWidth);
+			mPrefilterMinSharpness            = p.value("PrefilterMinSharpness", mPrefilterMinSharpness);
+			mPrefilterMaxSaturation           = p.value("PrefilterMaxSaturation", mPrefilterMaxSaturation);
+			mCalibWarmStart                   = p.value("CalibWarmStart", mCalibWarmStart);
+			mCalibWarmStartTolerance          = p.value("CalibWarmStartTolerance", mCalibWarmStartTolerance);
+			mCalibrationSolver                = p.value("CalibrationSolver", mCalibrationSolver);
+			mCalibOutlierRejection            = p.value("CalibOutlierRejection", mCalibOutlierRejection);
+			mCalibOutlierThreshold            = p.value("CalibOutlierThreshold", mCalibOutlierThreshold);
+			mBootstrapSamples                 = p.value("BootstrapSamples", mBootstrapSamples);
+			mBootstrapConfidence              = p.value("BootstrapConfidence", mBootstrapConfidence);
+			mViewSelectionSize                = p.value("ViewSelectionSize", mViewSelectionSize);
+			mBackgroundCalibration            = p.value("BackgroundCalibration", mBackgroundCalibration);
+			mCameraModel                      = p.value("CameraModel", mCameraModel);
+			mStereoTwoPhase                   = p.value("StereoTwoPhase", mStereoTwoPhase);
+			mStereoRefineIntrinsics           = p.value("StereoRefineIntrinsics", mStereoRefineIntrinsics);
+			mCoverageGridWidth                = p.value("CoverageGridWidth", mCoverageGridWidth);
+			mCoverageGridHeight               = p.value("CoverageGridHeight", mCoverageGridHeight);
+			mDisplayBufferPoolSize            = p.value("DisplayBufferPoolSize", mDisplayBufferPoolSize);
 			
 			return true;
 		}
@@ -168,7 +228,37 @@ void CalibratorConfiguration::saveConfiguration(nlohmann::json* json) const
 		{"CalibFixK2"                       , mCalibFixK2},
 		{"CalibFixK3"                       , mCalibFixK3},
 		{"CalibFixK4"                       , mCalibFixK4},
-		{"CalibFixK5"                       , mCalibFixK5}
+		{"CalibFixK5"                       , mCalibFixK5},
+		{"NumDetectionThreads"              , mNumDetectionThreads},
+		{"CornerRefinement"                 , mCornerRefinement},
+		{"PyramidTargetWidth"               , mPyramidTargetWidth},
+		{"PyramidMinSquareSize"             , mPyramidMinSquareSize},
+		{"TrackingMode"                     , mTrackingMode},
+		{"TrackingRoiMargin"                , mTrackingRoiMargin},
+		{"TrackingRedetectInterval"         , mTrackingRedetectInterval},
+		{"DetectionCacheDirectory"          , mDetectionCacheDirectory},
+		{"DetectorBackend"                  , mDetectorBackend},
+		{"DetectorExhaustive"               , mDetectorExhaustive},
+		{"DetectorAccuracy"                 , mDetectorAccuracy},
+		{"DetectorLarger"                   , mDetectorLarger},
+		{"PrefilterImageWidth"              , mPrefilterImageWidth},
+		{"PrefilterMinSharpness"            , mPrefilterMinSharpness},
+		{"PrefilterMaxSaturation"           , mPrefilterMaxSaturation},
+		{"CalibWarmStart"                   , mCalibWarmStart},
+		{"CalibWarmStartTolerance"          , mCalibWarmStartTolerance},
+		{"CalibrationSolver"                , mCalibrationSolver},
+		{"CalibOutlierRejection"            , mCalibOutlierRejection},
+		{"CalibOutlierThreshold"            , mCalibOutlierThreshold},
+		{"BootstrapSamples"                 , mBootstrapSamples},
+		{"BootstrapConfidence"              , mBootstrapConfidence},
+		{"ViewSelectionSize"                , mViewSelectionSize},
+		{"BackgroundCalibration"            , mBackgroundCalibration},
+		{"CameraModel"                      , mCameraModel},
+		{"StereoTwoPhase"                   , mStereoTwoPhase},
+		{"StereoRefineIntrinsics"           , mStereoRefineIntrinsics},
+		{"CoverageGridWidth"                , mCoverageGridWidth},
+		{"CoverageGridHeight"               , mCoverageGridHeight},
+		{"DisplayBufferPoolSize"            , mDisplayBufferPoolSize}
 	};
 }
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
@@ -191,4 +281,17 @@ int CalibratorConfiguration::calibrationFlag() const
 }
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// The camera calibration flag used by cv::fisheye. The model has no tangential distortion, aspect ratio or K5, and the 
+// extrinsics are recomputed in every iteration. The CalibFixK options describe the pinhole coefficients, so they are 
+// not passed on and all four equidistant coefficients are fitted.
+int CalibratorConfiguration::fisheyeCalibrationFlag() const
+{
+	int _calibrationFlag = cv::fisheye::CALIB_RECOMPUTE_EXTRINSIC | cv::fisheye::CALIB_FIX_SKEW;
+	if(calibFixPrincipalPoint()) {_calibrationFlag |= cv::fisheye::CALIB_FIX_PRINCIPAL_POINT;}
+	return _calibrationFlag;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
 }; // end namespace RCamera.
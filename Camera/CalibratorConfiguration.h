@@ -9,6 +9,80 @@
 namespace RCamera {
 ;
 
+// The CornerRefinementMode enumeration defines how chessboard corners found on the downscaled image are brought to full resolution.
+enum class CornerRefinementMode
+{
+	Redetect,     // Run the chessboard detector again on the full resolution image.
+	CoarseToFine, // Upscale the corners found on the downscaled image and refine them with cornerSubPix.
+	Compare       // Run both and print the difference. The corners of Redetect are used.
+};
+
+NLOHMANN_JSON_SERIALIZE_ENUM(CornerRefinementMode,
+{
+	{CornerRefinementMode::Redetect    , "Redetect"},
+	{CornerRefinementMode::CoarseToFine, "CoarseToFine"},
+	{CornerRefinementMode::Compare     , "Compare"}
+})
+
+
+// The DetectorBackend enumeration defines the OpenCV function used to find chessboard corners.
+enum class DetectorBackend
+{
+	Classic,    // cv::findChessboardCorners followed by cv::cornerSubPix.
+	SectorBased // cv::findChessboardCornersSB, which returns sub-pixel corners directly.
+};
+
+NLOHMANN_JSON_SERIALIZE_ENUM(DetectorBackend,
+{
+	{DetectorBackend::Classic    , "Classic"},
+	{DetectorBackend::SectorBased, "SectorBased"}
+})
+
+
+// The TrackingMode enumeration defines how chessboard corners of the previous image are used to find them in the next image.
+enum class TrackingMode
+{
+	None, // Search the whole image.
+	Roi,  // Search around the previous chessboard first and fall back to the whole image.
+	Flow  // Move the previous corners to the next image and verify the grid. The whole image is searched on tracking loss.
+};
+
+NLOHMANN_JSON_SERIALIZE_ENUM(TrackingMode,
+{
+	{TrackingMode::None, "None"},
+	{TrackingMode::Roi , "Roi"},
+	{TrackingMode::Flow, "Flow"}
+})
+
+
+// The CalibrationSolver enumeration defines the solver used to find the camera parameters.
+enum class CalibrationSolver
+{
+	OpenCV,  // cv::calibrateCamera, a dense Levenberg-Marquardt over all parameters.
+	SparseLM // SparseCalibrationSolver, which eliminates the extrinsics of each view with the Schur complement.
+};
+
+NLOHMANN_JSON_SERIALIZE_ENUM(CalibrationSolver,
+{
+	{CalibrationSolver::OpenCV  , "OpenCV"},
+	{CalibrationSolver::SparseLM, "SparseLM"}
+})
+
+
+// The CameraModel enumeration defines the lens model fitted by the calibrator.
+enum class CameraModel
+{
+	Pinhole, // MonoCameraCalibrator, pinhole with radial and tangential distortion.
+	Fisheye  // FisheyeCameraCalibrator, equidistant projection with four distortion coefficients for wide-angle lenses.
+};
+
+NLOHMANN_JSON_SERIALIZE_ENUM(CameraModel,
+{
+	{CameraModel::Pinhole, "Pinhole"},
+	{CameraModel::Fisheye, "Fisheye"}
+})
+
+
 // The CalibratorConfiguration class defines the configuration of the CameraCalibrator.
 class CalibratorConfiguration
 {
@@ -23,6 +97,7 @@ public:
 	void saveConfiguration(nlohmann::json* json) const;
 
 	int calibrationFlag() const;
+	int fisheyeCalibrationFlag() const;
 
 	inline bool        flipVertically()                   const {return mFlipVertically;}
 	inline int         boardWidth()                       const {return mBoardWidth;}
@@ -47,6 +122,36 @@ public:
 	inline bool        calibFixK3()                       const {return mCalibFixK3;}
 	inline bool        calibFixK4()                       const {return mCalibFixK4;}
 	inline bool        calibFixK5()                       const {return mCalibFixK5;}
+	inline int         numDetectionThreads()              const {return mNumDetectionThreads;}
+	inline CornerRefinementMode cornerRefinement()        const {return mCornerRefinement;}
+	inline int         pyramidTargetWidth()               const {return mPyramidTargetWidth;}
+	inline int         pyramidMinSquareSize()             const {return mPyramidMinSquareSize;}
+	inline TrackingMode trackingMode()                    const {return mTrackingMode;}
+	inline double      trackingRoiMargin()                const {return mTrackingRoiMargin;}
+	inline int         trackingRedetectInterval()         const {return mTrackingRedetectInterval;}
+	inline std::string detectionCacheDirectory()          const {return mDetectionCacheDirectory;}
+	inline DetectorBackend detectorBackend()              const {return mDetectorBackend;}
+	inline bool        detectorExhaustive()               const {return mDetectorExhaustive;}
+	inline bool        detectorAccuracy()                 const {return mDetectorAccuracy;}
+	inline bool        detectorLarger()                   const {return mDetectorLarger;}
+	inline int         prefilterImageWidth()              const {return mPrefilterImageWidth;}
+	inline double      prefilterMinSharpness()            const {return mPrefilterMinSharpness;}
+	inline double      prefilterMaxSaturation()           const {return mPrefilterMaxSaturation;}
+	inline bool        calibWarmStart()                   const {return mCalibWarmStart;}
+	inline double      calibWarmStartTolerance()          const {return mCalibWarmStartTolerance;}
+	inline CalibrationSolver calibrationSolver()          const {return mCalibrationSolver;}
+	inline bool        calibOutlierRejection()            const {return mCalibOutlierRejection;}
+	inline double      calibOutlierThreshold()            const {return mCalibOutlierThreshold;}
+	inline int         bootstrapSamples()                 const {return mBootstrapSamples;}
+	inline double      bootstrapConfidence()              const {return mBootstrapConfidence;}
+	inline int         viewSelectionSize()                const {return mViewSelectionSize;}
+	inline bool        backgroundCalibration()            const {return mBackgroundCalibration;}
+	inline CameraModel cameraModel()                      const {return mCameraModel;}
+	inline bool        stereoTwoPhase()                   const {return mStereoTwoPhase;}
+	inline bool        stereoRefineIntrinsics()           const {return mStereoRefineIntrinsics;}
+	inline int         coverageGridWidth()                const {return mCoverageGridWidth;}
+	inline int         coverageGridHeight()               const {return mCoverageGridHeight;}
+	inline int         displayBufferPoolSize()            const {return mDisplayBufferPoolSize;}
 
 	inline void setFlipVertically(bool x)                                 {mFlipVertically = x;}
 	inline void setBoardWidth(int x)                                      {mBoardWidth = x;}
@@ -71,6 +176,36 @@ public:
 	inline void setCalibFixK3(bool x)                                     {mCalibFixK3 = x;}
 	inline void setCalibFixK4(bool x)                                     {mCalibFixK4 = x;}
 	inline void setCalibFixK5(bool x)                                     {mCalibFixK5 = x;}
+	inline void setNumDetectionThreads(int x)                             {mNumDetectionThreads = x;}
+	inline void setCornerRefinement(CornerRefinementMode x)               {mCornerRefinement = x;}
+	inline void setPyramidTargetWidth(int x)                              {mPyramidTargetWidth = x;}
+	inline void setPyramidMinSquareSize(int x)                            {mPyramidMinSquareSize = x;}
+	inline void setTrackingMode(TrackingMode x)                           {mTrackingMode = x;}
+	inline void setTrackingRoiMargin(double x)                            {mTrackingRoiMargin = x;}
+	inline void setTrackingRedetectInterval(int x)                        {mTrackingRedetectInterval = x;}
+	inline void setDetectionCacheDirectory(const std::string& x)          {mDetectionCacheDirectory = x;}
+	inline void setDetectorBackend(DetectorBackend x)                     {mDetectorBackend = x;}
+	inline void setDetectorExhaustive(bool x)                             {mDetectorExhaustive = x;}
+	inline void setDetectorAccuracy(bool x)                               {mDetectorAccuracy = x;}
+	inline void setDetectorLarger(bool x)                                 {mDetectorLarger = x;}
+	inline void setPrefilterImageWidth(int x)                             {mPrefilterImageWidth = x;}
+	inline void setPrefilterMinSharpness(double x)                        {mPrefilterMinSharpness = x;}
+	inline void setPrefilterMaxSaturation(double x)                       {mPrefilterMaxSaturation = x;}
+	inline void setCalibWarmStart(bool x)                                 {mCalibWarmStart = x;}
+	inline void setCalibWarmStartTolerance(double x)                      {mCalibWarmStartTolerance = x;}
+	inline void setCalibrationSolver(CalibrationSolver x)                 {mCalibrationSolver = x;}
+	inline void setCalibOutlierRejection(bool x)                          {mCalibOutlierRejection = x;}
+	inline void setCalibOutlierThreshold(double x)                        {mCalibOutlierThreshold = x;}
+	inline void setBootstrapSamples(int x)                                {mBootstrapSamples = x;}
+	inline void setBootstrapConfidence(double x)                          {mBootstrapConfidence = x;}
+	inline void setViewSelectionSize(int x)                               {mViewSelectionSize = x;}
+	inline void setBackgroundCalibration(bool x)                          {mBackgroundCalibration = x;}
+	inline void setCameraModel(CameraModel x)                             {mCameraModel = x;}
+	inline void setStereoTwoPhase(bool x)                                 {mStereoTwoPhase = x;}
+	inline void setStereoRefineIntrinsics(bool x)                         {mStereoRefineIntrinsics = x;}
+	inline void setCoverageGridWidth(int x)                               {mCoverageGridWidth = x;}
+	inline void setCoverageGridHeight(int x)                              {mCoverageGridHeight = x;}
+	inline void setDisplayBufferPoolSize(int x)                           {mDisplayBufferPoolSize = x;}
 
 
 private:
@@ -100,6 +235,37 @@ private:
 	bool  mCalibFixK3;
 	bool  mCalibFixK4;
 	bool  mCalibFixK5;
+
+	int                  mNumDetectionThreads;      // The number of threads used to decode images and find chessboard corners. 0 uses all cores.
+	CornerRefinementMode mCornerRefinement;         // How the corners found on the downscaled image are refined to full resolution.
+	int                  mPyramidTargetWidth;       // The smallest image width used to quickly reject images. If this and mPyramidMinSquareSize are 0, half resolution is used.
+	int                  mPyramidMinSquareSize;     // The smallest chessboard square size in pixels the coarsest pyramid level must be able to show.
+	TrackingMode         mTrackingMode;             // How sequential images passed to setImage() are tracked.
+	double               mTrackingRoiMargin;        // The margin added on each side of the predicted chessboard as a fraction of its size.
+	int                  mTrackingRedetectInterval; // The number of images tracked with TrackingMode::Flow before the whole image is searched again.
+	std::string          mDetectionCacheDirectory;  // The directory used to cache chessboard detections between runs. Empty disables the cache.
+	DetectorBackend      mDetectorBackend;          // The OpenCV function used to find chessboard corners.
+	bool                 mDetectorExhaustive;       // SectorBased only: run an exhaustive search to improve the detection rate.
+	bool                 mDetectorAccuracy;         // SectorBased only: upsample the image to improve sub-pixel accuracy.
+	bool                 mDetectorLarger;           // SectorBased only: accept a larger pattern and use its central corners.
+	int                  mPrefilterImageWidth;      // The width of the downsampled image used to measure sharpness and saturation.
+	double               mPrefilterMinSharpness;    // Images with a lower Laplacian variance are rejected as blurred. 0 disables the check.
+	double               mPrefilterMaxSaturation;   // Images with a larger fraction of saturated pixels are rejected as overexposed. 1 disables the check.
+	bool                 mCalibWarmStart;           // If true, each calibration starts from the intrinsics of the previous successful calibration.
+	double               mCalibWarmStartTolerance;  // A warm started calibration stops when the relative parameter change is below this value.
+	CalibrationSolver    mCalibrationSolver;        // The solver used to find the camera parameters.
+	bool                 mCalibOutlierRejection;    // If true, views with outlying re-projection errors are dropped and the camera is calibrated again.
+	double               mCalibOutlierThreshold;    // Views with an error above the median by more than this many robust standard deviations (1.4826 MAD) are outliers.
+	int                  mBootstrapSamples;         // The number of bootstrap resamples used to estimate the uncertainty of the intrinsics after calibration. 0 disables it.
+	double               mBootstrapConfidence;      // The coverage of the confidence intervals estimated by the bootstrap.
+	int                  mViewSelectionSize;        // If more views are accepted, only this many views with the most diverse poses and coverage are kept. 0 keeps all views.
+	bool                 mBackgroundCalibration;    // If true, calibration runs on a background thread and a newer batch of images cancels it.
+	CameraModel          mCameraModel;              // The lens model fitted by the calibrator.
+	bool                 mStereoTwoPhase;           // If true, stereo calibration first calibrates each camera on its own, then only solves the relative pose.
+	bool                 mStereoRefineIntrinsics;   // With mStereoTwoPhase, refine the intrinsics in the stereo phase instead of keeping them fixed.
+	int                  mCoverageGridWidth;        // The number of columns of the coverage grid, 0 to measure coverage with a mask the size of the image.
+	int                  mCoverageGridHeight;       // The number of rows of the coverage grid.
+	int                  mDisplayBufferPoolSize;    // The number of display image buffers each camera keeps for reuse.
 };
 
 }; // end namespace RCamera
@@ -1,11 +1,20 @@
 
 #include "CameraCalibratorHelper.h"
+#include "DetectionCache.h"
+#include "DisplayBufferPool.h"
 
 #include "fmt/format.h"
 #include "opencv2/calib3d.hpp"
+#include "opencv2/core/hal/intrin.hpp"
 #include "opencv2/imgproc.hpp"
 #include "opencv2/highgui.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+
 
 namespace RCamera {
 ;
@@ -19,10 +28,21 @@ CameraCalibratorHelper::CameraCalibratorHelper()
 CameraCalibratorHelper::CameraCalibratorHelper(const CalibratorConfiguration& parameters)
 	: mConfiguration(parameters),
 	  mInputImageSize(-1, -1),
+	  mIsDisplayImageValid(false),
 	  mCoveragePercentage(0),
+	  mNumCoveredPixels(0),
+	  mNextViewId(0),
 	  mLastRmsError(std::numeric_limits<double>::max()),
-	  mCameraParamersValid(false)
+	  mCameraParamersValid(false),
+	  mTrackedVelocity(0, 0),
+	  mNumImagesTracked(0),
+	  mNumDroppedViews(0)
 {
+	mDisplayBufferPool = std::make_shared<DisplayBufferPool>(mConfiguration.displayBufferPoolSize());
+	if(!mConfiguration.detectionCacheDirectory().empty())
+	{
+		mDetectionCache = std::make_shared<DetectionCache>(mConfiguration.detectionCacheDirectory());
+	}
 }
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 
@@ -44,10 +64,53 @@ bool CameraCalibratorHelper::checkImageSize(int width, int height)
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 
 
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Copy the image data to an 8 bit cv::Mat, flipping it if required by the configuration.
+bool CameraCalibratorHelper::convertImage(const unsigned char* imageData, int width, int height, int bytesPerPixel, int numRowbytes, cv::Mat* image) const
+{
+	if(bytesPerPixel == 1)
+	{
+		*image = cv::Mat(cv::Size(width, height), CV_8UC1, (void*)imageData, numRowbytes);
+	}
+	else if(bytesPerPixel == 2)
+	{
+		*image = cv::Mat(cv::Size(width, height), CV_16UC1, (void*)imageData, numRowbytes);
+		image->convertTo(*image, CV_8UC1, 1.0/256.0);
+	}
+	else
+	{
+		return false;
+	}
+
+	// Flip into a new buffer so that the caller's image data is never modified.
+	if(mConfiguration.flipVertically())
+	{
+		cv::Mat _flippedImage;
+		cv::flip(*image, _flippedImage, 0);
+		*image = _flippedImage;
+	}
+
+	// The image must not reference the caller's buffer, which may be reused before the image is added.
+	if(image->data == imageData)
+	{
+		*image = image->clone();
+	}
+	return true;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 void CameraCalibratorHelper::createCoverageMask(int width, int height)
 {
-	if(mCoverageMask.empty())
+	if(_useCoverageGrid())
+	{
+		if(mCoverageGrid.empty())
+		{
+			mCoverageGrid = cv::Mat(mConfiguration.coverageGridHeight(), mConfiguration.coverageGridWidth(), CV_32SC1, cv::Scalar(0));
+		}
+	}
+	else if(mCoverageMask.empty())
 	{
 		mCoverageMask = cv::Mat(height, width, CV_8UC1, cv::Scalar(50)); // 20% tint.
 	}
@@ -56,30 +119,104 @@ void CameraCalibratorHelper::createCoverageMask(int width, int height)
 
 
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
-std::vector<cv::Point2f> CameraCalibratorHelper::findChessboardCorners(const cv::Mat& inputImage) const
+std::vector<cv::Point2f> CameraCalibratorHelper::findChessboardCorners(const cv::Mat& inputImage, std::vector<double>* levelTimesMS) const
 {
+	if(mConfiguration.detectorBackend() == DetectorBackend::SectorBased)
+	{
+		return _findChessboardCornersSB(inputImage, levelTimesMS);
+	}
+
 	const cv::Size2i _boardSize(mConfiguration.boardWidth(), mConfiguration.boardHeight());
 	const int        _cornerDetectionFlagsFast = cv::CALIB_CB_ADAPTIVE_THRESH | cv::CALIB_CB_NORMALIZE_IMAGE|cv::CALIB_CB_FAST_CHECK;
 	const int        _cornerDetectionFlags     = cv::CALIB_CB_ADAPTIVE_THRESH | cv::CALIB_CB_NORMALIZE_IMAGE;
 
+	std::vector<double> _levelTimesMS;
+	auto                _levelStartTime = std::chrono::high_resolution_clock::now();
+	auto                _addLevelTime   = [&](size_t level)
+	{
+		auto _time = std::chrono::high_resolution_clock::now();
+		_levelTimesMS[level] += std::chrono::duration<double, std::milli>(_time - _levelStartTime).count();
+		_levelStartTime = _time;
+	};
+
 	
 	// Use smaller image for quickly rejecting an image when there is no chess board pattern.
-	cv::Mat      _resizedImage;
-	const double _scale = 0.5;
-	cv::resize(inputImage, _resizedImage, cv::Size(), _scale, _scale, cv::INTER_LINEAR_EXACT);
+	const std::vector<cv::Mat> _pyramid   = _buildPyramid(inputImage, &_levelTimesMS);
+	const int                  _numLevels = int(_pyramid.size()) - 1;
+	_levelStartTime = std::chrono::high_resolution_clock::now();
 	
+	// The number of levels assumes that the board fills the image, so with a minimum square size a smaller board can be 
+	// too small to find on the coarsest level. It is then searched on each finer level in turn, down to the input image.
 	std::vector<cv::Point2f> _corners;
-	if(cv::findChessboardCorners(_resizedImage, _boardSize, _corners, _cornerDetectionFlagsFast))
+	int                      _level   = _numLevels;
+	bool                     _isFound = cv::findChessboardCorners(_pyramid[_level], _boardSize, _corners, _cornerDetectionFlagsFast);
+	_addLevelTime(_level);
+	while(!_isFound && _level > 0 && mConfiguration.pyramidMinSquareSize() > 0)
 	{
-		_corners.clear();
-		if(cv::findChessboardCorners(inputImage, _boardSize, _corners, _cornerDetectionFlags))
+		--_level;
+		_isFound = cv::findChessboardCorners(_pyramid[_level], _boardSize, _corners, _cornerDetectionFlagsFast);
+		_addLevelTime(_level);
+	}
+
+	if(_isFound)
+	{
+		// The corners are refined from the level they were found on.
+		const std::vector<cv::Mat> _levels(_pyramid.begin(), _pyramid.begin() + _level + 1);
+
+		if(_level == 0)
 		{
+			// The image is already small enough, the corners only need final refinement.
 			cv::TermCriteria _termCriteria = cv::TermCriteria(cv::TermCriteria::EPS + cv::TermCriteria::COUNT, 30, 0.1);
 			cv::cornerSubPix(inputImage, _corners, cv::Size(11, 11), cv::Size(-1, -1), _termCriteria);
+			_addLevelTime(0);
+		}
+		else if(mConfiguration.cornerRefinement() == CornerRefinementMode::CoarseToFine)
+		{
+			_corners = _refineCoarseCorners(_levels, _corners, &_levelTimesMS);
 		}
 		else
 		{
+			const std::vector<cv::Point2f> _coarseCorners = _corners;
+
 			_corners.clear();
+			if(cv::findChessboardCorners(inputImage, _boardSize, _corners, _cornerDetectionFlags))
+			{
+				cv::TermCriteria _termCriteria = cv::TermCriteria(cv::TermCriteria::EPS + cv::TermCriteria::COUNT, 30, 0.1);
+				cv::cornerSubPix(inputImage, _corners, cv::Size(11, 11), cv::Size(-1, -1), _termCriteria);
+			}
+			else
+			{
+				_corners.clear();
+			}
+			_addLevelTime(0);
+
+			if(mConfiguration.cornerRefinement() == CornerRefinementMode::Compare && 
+			   _corners.size() == _coarseCorners.size())
+			{
+				std::vector<double> _refinementTimesMS(_levels.size(), 0.0);
+				auto                _refinedCorners       = _refineCoarseCorners(_levels, _coarseCorners, &_refinementTimesMS);
+				double              _redetectTimeMS       = _levelTimesMS[0];
+				double              _coarseToFineTimeMS   = std::accumulate(_refinementTimesMS.begin(), _refinementTimesMS.end(), 0.0);
+				
+				// The detector may number the corners from the opposite end of the board.
+				if(!_refinedCorners.empty() && cv::norm(_refinedCorners.front() - _corners.front()) > cv::norm(_refinedCorners.back() - _corners.front()))
+				{
+					std::reverse(_refinedCorners.begin(), _refinedCorners.end());
+				}
+
+				if(_refinedCorners.size() == _corners.size())
+				{
+					double _maxDelta = 0;
+					for(size_t i=0 ; i<_corners.size() ; ++i)
+					{
+						_maxDelta = std::max(_maxDelta, double(cv::norm(_corners[i] - _refinedCorners[i])));
+					}
+					double _rmsDelta = cv::norm(_corners, _refinedCorners, cv::NORM_L2) / std::sqrt(double(_corners.size()));
+
+					std::cout << fmt::format("Corner refinement: Redetect={:.2f}ms, CoarseToFine={:.2f}ms, RMS delta={:.4f}px, Max delta={:.4f}px\n", 
+						                     _redetectTimeMS, _coarseToFineTimeMS, _rmsDelta, _maxDelta);
+				}
+			}
 		}
 	}
 	else
@@ -91,46 +228,638 @@ std::vector<cv::Point2f> CameraCalibratorHelper::findChessboardCorners(const cv:
 	{
 		_corners.clear();
 	}
+
+	if(levelTimesMS)
+	{
+		*levelTimesMS = _levelTimesMS;
+	}
+	return _corners;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// The sector based detector works on the input image and returns sub-pixel accurate corners, so neither the pyramid 
+// nor cornerSubPix are used.
+std::vector<cv::Point2f> CameraCalibratorHelper::_findChessboardCornersSB(const cv::Mat& inputImage, std::vector<double>* levelTimesMS) const
+{
+	const cv::Size2i _boardSize(mConfiguration.boardWidth(), mConfiguration.boardHeight());
+	int              _cornerDetectionFlags = cv::CALIB_CB_NORMALIZE_IMAGE;
+	if(mConfiguration.detectorExhaustive()) {_cornerDetectionFlags |= cv::CALIB_CB_EXHAUSTIVE;}
+	if(mConfiguration.detectorAccuracy())   {_cornerDetectionFlags |= cv::CALIB_CB_ACCURACY;}
+	if(mConfiguration.detectorLarger())     {_cornerDetectionFlags |= cv::CALIB_CB_LARGER;}
+
+	auto _startTime = std::chrono::high_resolution_clock::now();
+
+	std::vector<cv::Point2f> _corners;
+	cv::Mat                  _meta;
+	if(!cv::findChessboardCornersSB(inputImage, _boardSize, _corners, _cornerDetectionFlags, _meta))
+	{
+		_corners.clear();
+	}
+	else if(_corners.size() != size_t(_boardSize.height) * size_t(_boardSize.width) && mConfiguration.detectorLarger())
+	{
+		// The detected pattern is larger than the board. Any part of a chessboard is a chessboard, so use the 
+		// corners at its centre. The meta data has one element per detected corner.
+		std::vector<cv::Point2f> _largerCorners = _corners;
+		_corners.clear();
+		if(_meta.rows >= _boardSize.height && _meta.cols >= _boardSize.width && _largerCorners.size() == _meta.total())
+		{
+			const int _firstRow    = (_meta.rows - _boardSize.height) / 2;
+			const int _firstColumn = (_meta.cols - _boardSize.width) / 2;
+			for(int i = 0 ; i<_boardSize.height ; ++i)
+			{
+				for(int j = 0 ; j<_boardSize.width ; ++j)
+				{
+					_corners.push_back(_largerCorners[(_firstRow + i) * _meta.cols + _firstColumn + j]);
+				}
+			}
+		}
+	}
+
+	if(_corners.size() != size_t(_boardSize.height) * size_t(_boardSize.width))
+	{
+		_corners.clear();
+	}
+
+	if(levelTimesMS)
+	{
+		auto _endTime = std::chrono::high_resolution_clock::now();
+		levelTimesMS->assign(1, std::chrono::duration<double, std::milli>(_endTime - _startTime).count());
+	}
 	return _corners;
 }
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 
 
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Convert the image data, check the image quality and find the chessboard. The image of the detection is 
+// InvalidBytesPerPixel if the image data can't be converted.
+ChessboardDetection CameraCalibratorHelper::detectChessboard(const unsigned char* imageData, int width, int height, int bytesPerPixel, int numRowbytes) const
+{
+	cv::Mat _image;
+	if(!imageData || !convertImage(imageData, width, height, bytesPerPixel, numRowbytes, &_image))
+	{
+		ChessboardDetection _detection;
+		_detection.status    = CameraCalibrationStatus::InvalidBytesPerPixel;
+		_detection.imageSize = cv::Size(width, height);
+		return _detection;
+	}
+
+	ChessboardDetection _detection;
+	_detection.image     = _image;
+	_detection.imageSize = _image.size();
+	if(!checkImageQuality(_image, &_detection))
+	{
+		return _detection;
+	}
+
+	// The measured image quality is kept for accepted images as well.
+	ChessboardDetection _chessboard = detectChessboard(_image);
+	_chessboard.sharpness  = _detection.sharpness;
+	_chessboard.saturation = _detection.saturation;
+	return _chessboard;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+ChessboardDetection CameraCalibratorHelper::detectChessboard(const cv::Mat& inputImage) const
+{
+	ChessboardDetection _detection;
+	_detection.image     = inputImage;
+	_detection.imageSize = inputImage.size();
+
+	auto        _startTime = std::chrono::high_resolution_clock::now();
+	std::string _cacheKey;
+	if(mDetectionCache)
+	{
+		_cacheKey = mDetectionCache->createKey(inputImage, mConfiguration);
+		if(mDetectionCache->load(_cacheKey, &_detection))
+		{
+			auto _endTime = std::chrono::high_resolution_clock::now();
+			_detection.detectionTimeMS = std::chrono::duration<double, std::milli>(_endTime - _startTime).count();
+			return _detection;
+		}
+	}
+
+	_detection.corners = findChessboardCorners(inputImage, &_detection.levelTimesMS);
+	auto _endTime = std::chrono::high_resolution_clock::now();
+	_detection.detectionTimeMS = std::chrono::duration<double, std::milli>(_endTime - _startTime).count();
+
+	_updateDetectionQuality(&_detection);
+
+	if(mDetectionCache)
+	{
+		mDetectionCache->save(_cacheKey, _detection);
+	}
+	return _detection;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Detect the chessboard in a burst of 8 bit images using the parallel backend OpenCV was built with. The results are 
+// in the order of the input images and can be passed to addDetection() of a calibrator.
+// The images must already come from convertImage(), no conversion or FlipVertically is applied here.
+std::vector<ChessboardDetection> CameraCalibratorHelper::findChessboardCornersBatch(const std::vector<cv::Mat>& inputImages) const
+{
+	for(const cv::Mat& _image : inputImages)
+	{
+		CV_Assert(_image.type() == CV_8UC1);
+	}
+
+	std::vector<ChessboardDetection> _detections(inputImages.size());
+	cv::parallel_for_(cv::Range(0, int(inputImages.size())), [&](const cv::Range& range)
+	{
+		for(int i = range.start ; i<range.end ; ++i)
+		{
+			ChessboardDetection& _detection = _detections[i];
+			_detection.image     = inputImages[i];
+			_detection.imageSize = inputImages[i].size();
+			if(checkImageQuality(inputImages[i], &_detection))
+			{
+				const double _sharpness  = _detection.sharpness;
+				const double _saturation = _detection.saturation;
+				_detection            = detectChessboard(inputImages[i]);
+				_detection.sharpness  = _sharpness;
+				_detection.saturation = _saturation;
+			}
+		}
+	});
+	return _detections;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Convert the image data of the next image of a sequence, check the image quality and find the chessboard. The 
+// chessboard is tracked from the previous image if a TrackingMode is configured. Rejected images are skipped by the 
+// tracker, so the chessboard is predicted from the last good image.
+ChessboardDetection CameraCalibratorHelper::trackChessboard(const unsigned char* imageData, int width, int height, int bytesPerPixel, int numRowbytes)
+{
+	if(mConfiguration.trackingMode() == TrackingMode::None)
+	{
+		return detectChessboard(imageData, width, height, bytesPerPixel, numRowbytes);
+	}
+
+	cv::Mat _image;
+	if(!imageData || !convertImage(imageData, width, height, bytesPerPixel, numRowbytes, &_image))
+	{
+		ChessboardDetection _detection;
+		_detection.status    = CameraCalibrationStatus::InvalidBytesPerPixel;
+		_detection.imageSize = cv::Size(width, height);
+		return _detection;
+	}
+
+	ChessboardDetection _detection;
+	_detection.image     = _image;
+	_detection.imageSize = _image.size();
+	if(!checkImageQuality(_image, &_detection))
+	{
+		return _detection;
+	}
+
+	ChessboardDetection _chessboard = trackChessboard(_image);
+	_chessboard.sharpness  = _detection.sharpness;
+	_chessboard.saturation = _detection.saturation;
+	return _chessboard;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Search the region around the chessboard predicted from previous images first, or move the previous corners to 
+// the new image. The whole image is only searched when the chessboard is lost.
+ChessboardDetection CameraCalibratorHelper::trackChessboard(const cv::Mat& inputImage)
+{
+	ChessboardDetection _detection;
+	_detection.image     = inputImage;
+	_detection.imageSize = inputImage.size();
+
+	auto _startTime = std::chrono::high_resolution_clock::now();
+	if(mConfiguration.trackingMode() == TrackingMode::Flow && !mTrackedCorners.empty() && 
+	   mNumImagesTracked < mConfiguration.trackingRedetectInterval())
+	{
+		_detection.corners = _propagateCorners(inputImage, &_detection.levelTimesMS);
+	}
+	
+	if(mConfiguration.trackingMode() == TrackingMode::Roi && !mTrackedCorners.empty())
+	{
+		const cv::Rect _roi = _predictTrackingRoi(inputImage.size());
+		if(!_roi.empty())
+		{
+			_detection.corners = findChessboardCorners(inputImage(_roi), &_detection.levelTimesMS);
+			for(cv::Point2f& _corner : _detection.corners)
+			{
+				_corner += cv::Point2f(_roi.tl());
+			}
+		}
+	}
+
+	if(_detection.corners.empty())
+	{
+		_detection.corners = findChessboardCorners(inputImage, &_detection.levelTimesMS);
+		mNumImagesTracked  = 0;
+	}
+	else
+	{
+		mNumImagesTracked++;
+	}
+	auto _endTime = std::chrono::high_resolution_clock::now();
+	_detection.detectionTimeMS = std::chrono::duration<double, std::milli>(_endTime - _startTime).count();
+
+	// Keep the shift of the chessboard between the last two images to predict the next position.
+	if(!mTrackedCorners.empty() && !_detection.corners.empty())
+	{
+		mTrackedVelocity = _centroid(_detection.corners) - _centroid(mTrackedCorners);
+	}
+	else
+	{
+		mTrackedVelocity = cv::Point2f(0, 0);
+	}
+	mTrackedCorners = _detection.corners;
+
+	_updateDetectionQuality(&_detection);
+	return _detection;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Reject blurred and overexposed images before the chessboard detector runs. Both measures are computed on a 
+// downsampled image, so the check takes a fraction of a millisecond. Returns false and sets the status of the 
+// detection if the image is rejected.
+bool CameraCalibratorHelper::checkImageQuality(const cv::Mat& inputImage, ChessboardDetection* detection) const
+{
+	const bool _checkSharpness  = mConfiguration.prefilterMinSharpness() > 0;
+	const bool _checkSaturation = mConfiguration.prefilterMaxSaturation() < 1;
+	if(!_checkSharpness && !_checkSaturation)
+	{
+		return true;
+	}
+
+	// Downsample by an integer factor, for which OpenCV uses a vectorised box filter.
+	cv::Mat   _smallImage = inputImage;
+	const int _factor     = std::max(1, inputImage.cols / std::max(1, mConfiguration.prefilterImageWidth()));
+	if(_factor > 1)
+	{
+		const cv::Size _smallSize(inputImage.cols / _factor, inputImage.rows / _factor);
+		cv::resize(inputImage(cv::Rect(0, 0, _smallSize.width * _factor, _smallSize.height * _factor)), _smallImage, _smallSize, 0, 0, cv::INTER_AREA);
+	}
+
+	const int _saturationLevel = 250;
+	detection->saturation = double(cv::countNonZero(_smallImage >= _saturationLevel)) / double(_smallImage.total());
+	if(_checkSaturation && detection->saturation > mConfiguration.prefilterMaxSaturation())
+	{
+		detection->status = CameraCalibrationStatus::ImageOverexposed;
+		return false;
+	}
+
+	cv::Mat    _laplacian;
+	cv::Scalar _mean, _standardDeviation;
+	cv::Laplacian(_smallImage, _laplacian, CV_16S);
+	cv::meanStdDev(_laplacian, _mean, _standardDeviation);
+	detection->sharpness = _standardDeviation[0] * _standardDeviation[0];
+	if(_checkSharpness && detection->sharpness < mConfiguration.prefilterMinSharpness())
+	{
+		detection->status = CameraCalibrationStatus::ImageBlurred;
+		return false;
+	}
+
+	return true;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 void CameraCalibratorHelper::updateCorners(const cv::Mat&           inputImage, 
 	                                       std::vector<cv::Point2f> corners)
 {
 	mAllChessBoardCorners.emplace_back(corners);
+	mViewIds.push_back(mNextViewId++);
 	_updateCoverageMask(corners);
 }
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 
 
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
-void CameraCalibratorHelper::updateDisplayImage(const cv::Mat& inputImage)
+// Add a detection to the views of a calibrator and update its image counters. Returns ImageAccepted if the detection 
+// was added as a new view, otherwise the reason it was not.
+CameraCalibrationStatus CameraCalibratorHelper::addDetection(const ChessboardDetection& detection, int* numImagesAdded, int* numImagesAccepted)
+{
+	// Size of the input image must be same as previously added images.
+	if(!checkImageSize(detection.imageSize.width, detection.imageSize.height))
+	{
+		return CameraCalibrationStatus::ImageSizeInvalid;
+	}
+
+	// Don't accept images after the maximum number number of images has been accepted.
+	if(*numImagesAccepted > mConfiguration.maxNumImages())
+	{
+		return CameraCalibrationStatus::CalibrationFailed;
+	}
+
+	if(detection.status == CameraCalibrationStatus::InvalidBytesPerPixel)
+	{
+		return CameraCalibrationStatus::InvalidBytesPerPixel;
+	}
+
+	(*numImagesAdded)++;
+
+	// If this is the first image, create coverage mask.
+	createCoverageMask(detection.imageSize.width, detection.imageSize.height);
+
+	if(detection.status == CameraCalibrationStatus::ImageAccepted)
+	{
+		(*numImagesAccepted)++;
+		addView(detection);
+	}
+	else
+	{
+		// The status tells if the image was rejected by the quality check or by the chessboard detector.
+		setDisplayImage(detection.image);
+	}
+	return detection.status;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// True if enough images with enough coverage have been accepted to calibrate the next batch.
+bool CameraCalibratorHelper::isBatchComplete(int numImagesAccepted) const
 {
-	// Add coverage to the display image.
-	cv::cvtColor(inputImage, mDisplayImage, cv::COLOR_GRAY2RGB);
+	bool b1 = numImagesAccepted   >= mConfiguration.minNumImages();
+	bool b2 = mCoveragePercentage > mConfiguration.minCoverage();
+	int  b3 = numImagesAccepted   % mConfiguration.imageBatchSize();
+	return b1 && b2 && b3==0;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 
-	cv::Mat _redChannel;
-	cv::extractChannel(mDisplayImage, _redChannel, 0);
-	cv::add(_redChannel, mCoverageMask, _redChannel);
-	cv::insertChannel(_redChannel, mDisplayImage, 0);
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Add the image and corners of an accepted detection as a new view. The accepted image and the image with the corners 
+// are saved if configured. Files are numbered by view id, so they are never overwritten when views are dropped.
+void CameraCalibratorHelper::addView(const ChessboardDetection& detection)
+{
+	const int _imageIndex = mNextViewId + 1;
+	mAcceptedImages.push_back(detection.image);
+
+	if(mConfiguration.drawAcceptedImage())
+	{
+		std::string _fileName = fmt::format("{}{:04d}.png", mConfiguration.acceptedImageFilePrefix(), _imageIndex);
+		cv::imwrite(_fileName, detection.image);
+	}
+
+	updateCorners(detection.image, detection.corners);
+	setDisplayImage(detection.image, detection.corners);
+
+	if(mConfiguration.drawChessboardCorners() && !mConfiguration.saveOnlyLastChessboardImage())
+	{
+		saveChessboardCorners(_imageIndex, "");
+	}
 }
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 
 
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
-void CameraCalibratorHelper::drawChessboardCorners(const std::vector<cv::Point2f>& corners)
+// Remove views from calibration. The coverage mask is drawn again from the remaining views.
+void CameraCalibratorHelper::removeViews(std::vector<size_t> viewIndices)
 {
-	const cv::Size2i _boardSize(mConfiguration.boardWidth(), mConfiguration.boardHeight());
-	cv::drawChessboardCorners(mDisplayImage, _boardSize, cv::Mat(corners), true);
+	std::sort(viewIndices.rbegin(), viewIndices.rend());
+	viewIndices.erase(std::unique(viewIndices.begin(), viewIndices.end()), viewIndices.end());
+	for(size_t i : viewIndices)
+	{
+		if(i < mAllChessBoardCorners.size()) {mAllChessBoardCorners.erase(mAllChessBoardCorners.begin() + i);}
+		if(i < mAcceptedImages.size())       {mAcceptedImages.erase(mAcceptedImages.begin() + i);}
+		if(i < mViewIds.size())              {mViewIds.erase(mViewIds.begin() + i);}
+	}
+	if(!mCoverageMask.empty() || !mCoverageGrid.empty())
+	{
+		if(!mCoverageMask.empty()) {mCoverageMask.setTo(cv::Scalar(50));}
+		if(!mCoverageGrid.empty()) {mCoverageGrid.setTo(cv::Scalar(0));}
+		mIsDisplayImageValid = false;
+		mCoveragePercentage  = 0;
+		mNumCoveredPixels    = 0;
+		for(const std::vector<cv::Point2f>& _corners : mAllChessBoardCorners)
+		{
+			_updateCoverageMask(_corners);
+		}
+	}
 }
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Choose the numViews views which are most informative for calibration. The board pose of each view is estimated with 
+// solvePnP from the current intrinsics, or from a guess before the first calibration. Views are then picked greedily, 
+// each time the one whose pose and position are furthest from the views picked so far plus the image area it adds to 
+// the coverage. Returns the indices of the selected views in ascending order.
+std::vector<size_t> CameraCalibratorHelper::selectViews(size_t numViews) const
+{
+	const size_t        _numAllViews = mAllChessBoardCorners.size();
+	std::vector<size_t> _selected;
+	if(numViews >= _numAllViews)
+	{
+		_selected.resize(_numAllViews);
+		std::iota(_selected.begin(), _selected.end(), size_t(0));
+		return _selected;
+	}
+
+	const double _imageWidth  = mInputImageSize.width;
+	const double _imageHeight = mInputImageSize.height;
+	cv::Matx33d  _intrinsicMatrix(std::max(_imageWidth, _imageHeight), 0, 0.5*(_imageWidth - 1), 0, std::max(_imageWidth, _imageHeight), 0.5*(_imageHeight - 1), 0, 0, 1);
+	cv::Mat      _distortionCoeffs;
+	if(mCameraParamersValid)
+	{
+		_intrinsicMatrix  = cv::Matx33d(mIntrinsicMatrix);
+		_distortionCoeffs = mDistortionCoeffs;
+	}
+
+	// Each view is described by the tilt of the board, the position of its centre in the image and its size. The image 
+	// is divided into a grid of cells to measure the coverage.
+	typedef cv::Vec<double, 5>     Feature;
+	const int                      _gridWidth  = 16;
+	const int                      _gridHeight = 12;
+	const size_t                   _width      = mConfiguration.boardWidth();
+	const size_t                   _height     = mConfiguration.boardHeight();
+	const std::vector<cv::Point3f> _board      = calculateChessboard3DCornerPositions();
+	std::vector<Feature>           _features(_numAllViews);
+	std::vector<cv::Mat>           _cells(_numAllViews);
+	cv::parallel_for_(cv::Range(0, int(_numAllViews)), [&](const cv::Range& range)
+	{
+		for(int i = range.start ; i<range.end ; ++i)
+		{
+			const std::vector<cv::Point2f>& _corners = mAllChessBoardCorners[i];
+
+			cv::Vec3d _rotation, _translation;
+			cv::solvePnP(_board, _corners, _intrinsicMatrix, _distortionCoeffs, _rotation, _translation, false, cv::SOLVEPNP_IPPE);
+			cv::Matx33d _R;
+			cv::Rodrigues(_rotation, _R);
+			const double _sign = _R(2, 2) > 0 ? -1.0 : 1.0; // Use the normal facing the camera.
+
+			const std::vector<cv::Point2f> _outline = {_corners[0], _corners[_width - 1], _corners[_height * _width - 1], _corners[(_height - 1) * _width]};
+			const cv::Point2f              _center  = _centroid(_corners);
+			_features[i] = Feature(_sign * _R(0, 2), _sign * _R(1, 2), 
+			                       2 * _center.x / _imageWidth - 1, 2 * _center.y / _imageHeight - 1, 
+			                       std::sqrt(std::abs(cv::contourArea(_outline)) / (_imageWidth * _imageHeight)));
+
+			_cells[i] = cv::Mat(_gridHeight, _gridWidth, CV_8UC1, cv::Scalar(0));
+			for(int y = 0 ; y<_gridHeight ; ++y)
+			{
+				for(int x = 0 ; x<_gridWidth ; ++x)
+				{
+					const cv::Point2f _cellCenter(float((x + 0.5) * _imageWidth / _gridWidth), float((y + 0.5) * _imageHeight / _gridHeight));
+					_cells[i].at<uchar>(y, x) = cv::pointPolygonTest(_outline, _cellCenter, false) >= 0 ? 1 : 0;
+				}
+			}
+		}
+	});
+
+	// Start with the most tilted view.
+	size_t _next         = 0;
+	double _largestTilt  = -1;
+	for(size_t i = 0 ; i<_numAllViews ; ++i)
+	{
+		const double _tilt = _features[i][0]*_features[i][0] + _features[i][1]*_features[i][1];
+		if(_tilt > _largestTilt) {_largestTilt = _tilt; _next = i;}
+	}
+
+	std::vector<double> _minDistances(_numAllViews, std::numeric_limits<double>::max());
+	std::vector<bool>   _isSelected(_numAllViews, false);
+	cv::Mat             _covered(_gridHeight, _gridWidth, CV_8UC1, cv::Scalar(0));
+	while(true)
+	{
+		_selected.push_back(_next);
+		_isSelected[_next] = true;
+		_covered |= _cells[_next];
+		if(_selected.size() == numViews)
+		{
+			break;
+		}
+
+		double _bestScore = -1;
+		for(size_t i = 0 ; i<_numAllViews ; ++i)
+		{
+			if(_isSelected[i])
+			{
+				continue;
+			}
+			_minDistances[i] = std::min(_minDistances[i], cv::norm(_features[i] - _features[_selected.back()]));
+
+			const double _coverageGain = double(cv::countNonZero(_cells[i] & ~_covered)) / (_gridWidth * _gridHeight);
+			const double _score        = _minDistances[i] + _coverageGain;
+			if(_score > _bestScore) {_bestScore = _score; _next = i;}
+		}
+	}
+
+	std::sort(_selected.begin(), _selected.end());
+	return _selected;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Keep the image and corners for the display image. Nothing is drawn until renderDisplayImage() is called, so images 
+// which are never shown or saved cost nothing.
+void CameraCalibratorHelper::setDisplayImage(const cv::Mat& inputImage, const std::vector<cv::Point2f>& corners)
+{
+	mDisplayGrayImage    = inputImage;
+	mDisplayCorners      = corners;
+	mIsDisplayImageValid = false;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Draw the coverage and the chessboard corners on the last display image if it changed since it was last rendered.
+// The image is drawn into a free buffer of the pool, never into a buffer still held by an image returned earlier.
+const cv::Mat& CameraCalibratorHelper::renderDisplayImage() const
+{
+	if(!mIsDisplayImageValid && !mDisplayGrayImage.empty())
+	{
+		cv::Mat _displayImage = mDisplayBufferPool->acquire(mDisplayGrayImage.size(), CV_8UC3);
+
+		// Add coverage to the display image.
+		tintGrayImage(mDisplayGrayImage, coverageOverlay(), &_displayImage);
+		if(!mDisplayCorners.empty())
+		{
+			const cv::Size2i _boardSize(mConfiguration.boardWidth(), mConfiguration.boardHeight());
+			cv::drawChessboardCorners(_displayImage, _boardSize, cv::Mat(mDisplayCorners), true);
+		}
+		mDisplayImage        = _displayImage;
+		mIsDisplayImageValid = true;
+	}
+	return mDisplayImage;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Write the RGB image of a gray image with the tint added to the red channel in a single pass. This gives the same 
+// result as cvtColor, extractChannel, add and insertChannel without the temporary images. The rows are split between 
+// threads and each row is processed with the widest SIMD registers available.
+void CameraCalibratorHelper::tintGrayImage(const cv::Mat& grayImage, const cv::Mat& tint, cv::Mat* rgbImage)
+{
+	CV_Assert(grayImage.type() == CV_8UC1 && tint.type() == CV_8UC1 && grayImage.size() == tint.size());
+	rgbImage->create(grayImage.size(), CV_8UC3);
+
+	cv::parallel_for_(cv::Range(0, grayImage.rows), [&](const cv::Range& range)
+	{
+		for(int y = range.start ; y<range.end ; ++y)
+		{
+			const uchar* _grayRow = grayImage.ptr<uchar>(y);
+			const uchar* _tintRow = tint.ptr<uchar>(y);
+			uchar*       _rgbRow  = rgbImage->ptr<uchar>(y);
+
+			int x = 0;
+			#if CV_SIMD
+				for( ; x<=grayImage.cols - cv::v_uint8::nlanes ; x+=cv::v_uint8::nlanes)
+				{
+					const cv::v_uint8 _gray = cv::vx_load(_grayRow + x);
+					const cv::v_uint8 _red  = _gray + cv::vx_load(_tintRow + x); // Saturating add.
+					cv::v_store_interleave(_rgbRow + 3*x, _red, _gray, _gray);
+				}
+			#endif
+			for( ; x<grayImage.cols ; ++x)
+			{
+				_rgbRow[3*x]     = cv::saturate_cast<uchar>(_grayRow[x] + _tintRow[x]);
+				_rgbRow[3*x + 1] = _grayRow[x];
+				_rgbRow[3*x + 2] = _grayRow[x];
+			}
+		}
+	});
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// The tint added to the red channel of the display image, 50 where the image isn't covered yet. With the coverage grid 
+// the overlay is rendered from the cells only when it is requested.
+cv::Mat CameraCalibratorHelper::coverageOverlay() const
+{
+	if(mCoverageGrid.empty())
+	{
+		return mCoverageMask;
+	}
+
+	cv::Mat _cells(mCoverageGrid.size(), CV_8UC1, cv::Scalar(0));
+	_cells.setTo(cv::Scalar(50), mCoverageGrid == 0); // 20% tint.
+
+	cv::Mat _overlay;
+	cv::resize(_cells, _overlay, mInputImageSize, 0, 0, cv::INTER_NEAREST);
+	return _overlay;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 void CameraCalibratorHelper::saveChessboardCorners(int imageIndex, const std::string& cameraStr)
 {
 	std::string _fileName = fmt::format("{}{}_{:04d}.png", mConfiguration.chessboardCornersImageFilePrefix(), cameraStr, imageIndex);
-	cv::cvtColor(mDisplayImage, mDisplayImage, cv::COLOR_RGB2BGR);
-	cv::imwrite(_fileName, mDisplayImage);
+	cv::Mat     _image;
+	cv::cvtColor(renderDisplayImage(), _image, cv::COLOR_RGB2BGR);
+	cv::imwrite(_fileName, _image);
 }
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 
@@ -152,28 +881,174 @@ std::vector<cv::Point3f> CameraCalibratorHelper::calculateChessboard3DCornerPosi
 
 
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
-double CameraCalibratorHelper::calculateReprojectionErrors(const std::vector<std::vector<cv::Point3f>>& allChessBoard3DCornerPositions,
-	                                                       const std::vector<cv::Mat>&                  rotationVectors,
-	                                                       const std::vector<cv::Mat>&                  translationVectors) const
+// Project the corners of one view with the pinhole and rational distortion model of cv::projectPoints and write the 
+// residuals. The loop has no branches or allocations, so the compiler can vectorise it. Also writes the sum of squared 
+// residuals and the largest squared residual.
+static void _projectView(const cv::Matx33d& R, const cv::Vec3d& t, const cv::Matx33d& K, const double* k, 
+	                     const cv::Point3f* objectPoints, const cv::Point2f* imagePoints, int numPoints, cv::Point2f* residuals, 
+	                     double* sumSquaredError, double* maxSquaredError)
+{
+	const double _fx = K(0, 0), _fy = K(1, 1), _cx = K(0, 2), _cy = K(1, 2);
+	double _sum = 0;
+	double _max = 0;
+	for(int j = 0 ; j<numPoints ; ++j)
+	{
+		const double _X = R(0, 0)*objectPoints[j].x + R(0, 1)*objectPoints[j].y + R(0, 2)*objectPoints[j].z + t[0];
+		const double _Y = R(1, 0)*objectPoints[j].x + R(1, 1)*objectPoints[j].y + R(1, 2)*objectPoints[j].z + t[1];
+		const double _Z = R(2, 0)*objectPoints[j].x + R(2, 1)*objectPoints[j].y + R(2, 2)*objectPoints[j].z + t[2];
+		const double _x = _X / _Z;
+		const double _y = _Y / _Z;
+
+		const double _r2     = _x*_x + _y*_y;
+		const double _r4     = _r2*_r2;
+		const double _r6     = _r4*_r2;
+		const double _radial = (1 + k[0]*_r2 + k[1]*_r4 + k[4]*_r6) / (1 + k[5]*_r2 + k[6]*_r4 + k[7]*_r6);
+		const double _xd     = _x*_radial + 2*k[2]*_x*_y + k[3]*(_r2 + 2*_x*_x);
+		const double _yd     = _y*_radial + k[2]*(_r2 + 2*_y*_y) + 2*k[3]*_x*_y;
+
+		const double _dx = _fx*_xd + _cx - imagePoints[j].x;
+		const double _dy = _fy*_yd + _cy - imagePoints[j].y;
+		const double _e2 = _dx*_dx + _dy*_dy;
+		residuals[j] = cv::Point2f(float(_dx), float(_dy));
+		_sum += _e2;
+		_max  = std::max(_max, _e2);
+	}
+	*sumSquaredError = _sum;
+	*maxSquaredError = _max;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// The residuals of the pinhole model are computed by _projectView() without building the projected points. If the camera 
+// was solved on a subset of the views, viewIndices holds the index of each solved view in mAllChessBoardCorners.
+const ReprojectionErrors& CameraCalibratorHelper::calculateReprojectionErrors(const std::vector<std::vector<cv::Point3f>>& allChessBoard3DCornerPositions,
+	                                                                          const std::vector<cv::Mat>&                  rotationVectors,
+	                                                                          const std::vector<cv::Mat>&                  translationVectors,
+	                                                                          const std::vector<size_t>*                   viewIndices)
+{
+	// Distortion coefficients k1, k2, p1, p2, k3, k4, k5, k6. Missing coefficients are 0.
+	double _k[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+	for(int i = 0 ; i<std::min(int(mDistortionCoeffs.total()), 8) ; ++i)
+	{
+		_k[i] = mDistortionCoeffs.at<double>(i);
+	}
+	const cv::Matx33d _K(mIntrinsicMatrix);
+
+	return _calculateReprojectionErrors(allChessBoard3DCornerPositions, viewIndices, 
+		[&](int view, const std::vector<cv::Point2f>& imagePoints, cv::Point2f* residuals, double* sumSquaredError, double* maxSquaredError)
+	{
+		cv::Matx33d _R;
+		cv::Rodrigues(rotationVectors[view], _R);
+		const cv::Vec3d _t(translationVectors[view].ptr<double>());
+
+		const std::vector<cv::Point3f>& _objectPoints = allChessBoard3DCornerPositions[view];
+		_projectView(_R, _t, _K, _k, _objectPoints.data(), imagePoints.data(), int(_objectPoints.size()), residuals, sumSquaredError, maxSquaredError);
+	});
+}
+
+// Camera models other than the pinhole model pass a function which projects the corners of one view.
+const ReprojectionErrors& CameraCalibratorHelper::calculateReprojectionErrors(const std::vector<std::vector<cv::Point3f>>& allChessBoard3DCornerPositions,
+	                                                                          const ProjectionFunction&                    projectView,
+	                                                                          const std::vector<size_t>*                   viewIndices)
+{
+	return _calculateReprojectionErrors(allChessBoard3DCornerPositions, viewIndices, 
+		[&](int view, const std::vector<cv::Point2f>& imagePoints, cv::Point2f* residuals, double* sumSquaredError, double* maxSquaredError)
+	{
+		std::vector<cv::Point2f> _projected;
+		projectView(view, allChessBoard3DCornerPositions[view], &_projected);
+
+		double _sum = 0;
+		double _max = 0;
+		for(size_t j = 0 ; j<imagePoints.size() ; ++j)
+		{
+			residuals[j]     = _projected[j] - imagePoints[j];
+			const double _e2 = double(residuals[j].x)*residuals[j].x + double(residuals[j].y)*residuals[j].y;
+			_sum += _e2;
+			_max  = std::max(_max, _e2);
+		}
+		*sumSquaredError = _sum;
+		*maxSquaredError = _max;
+	});
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Views are processed in parallel into buffers which are allocated once for the maximum number of images. The residual 
+// function writes the residuals of one view and its sum and largest squared residual.
+const ReprojectionErrors& CameraCalibratorHelper::_calculateReprojectionErrors(const std::vector<std::vector<cv::Point3f>>& allChessBoard3DCornerPositions,
+	                                                                           const std::vector<size_t>*                   viewIndices,
+	                                                                           const ResidualFunction&                      calculateResiduals)
 {
-	const size_t _numImages  = allChessBoard3DCornerPositions.size();
-	const size_t _numCorners = allChessBoard3DCornerPositions[0].size();
+	const size_t _numViews   = viewIndices ? viewIndices->size() : mAllChessBoardCorners.size();
+	const int    _numImages  = int(std::min(allChessBoard3DCornerPositions.size(), _numViews));
+	const int    _numCorners = _numImages > 0 ? int(allChessBoard3DCornerPositions[0].size()) : 0;
+
+	if(mResidualBuffer.rows < _numImages || mResidualBuffer.cols != _numCorners)
+	{
+		mResidualBuffer.create(std::max(_numImages, mConfiguration.maxNumImages() + 1), _numCorners, CV_32FC2);
+		mReprojectionErrors.viewErrors.reserve(mResidualBuffer.rows);
+	}
+	mReprojectionErrors.residuals = mResidualBuffer.rowRange(0, _numImages);
+	mReprojectionErrors.viewErrors.resize(_numImages);
+
+	std::vector<double> _maxSquaredErrors(_numImages, 0.0);
+	cv::parallel_for_(cv::Range(0, _numImages), [&](const cv::Range& range)
+	{
+		for(int i = range.start ; i<range.end ; ++i)
+		{
+			double _sumSquaredError = 0;
+			const std::vector<cv::Point2f>& _imagePoints = mAllChessBoardCorners[viewIndices ? (*viewIndices)[i] : size_t(i)];
+			calculateResiduals(i, _imagePoints, mReprojectionErrors.residuals.ptr<cv::Point2f>(i), &_sumSquaredError, &_maxSquaredErrors[i]);
+			mReprojectionErrors.viewErrors[i] = _numCorners > 0 ? std::sqrt(_sumSquaredError / _numCorners) : 0.0;
+		}
+	});
 
-	size_t _totalPoints = 0;
 	double _totalError = 0;
-	for(size_t i=0 ; i<_numImages ; ++i)
+	double _maxError   = 0;
+	for(int i = 0 ; i<_numImages ; ++i)
 	{
-		std::vector<cv::Point2f> _projectImagePoints;
-		cv::projectPoints(allChessBoard3DCornerPositions[i], rotationVectors[i], translationVectors[i], 
-			              mIntrinsicMatrix, mDistortionCoeffs, _projectImagePoints);
+		_totalError += mReprojectionErrors.viewErrors[i] * mReprojectionErrors.viewErrors[i] * _numCorners;
+		_maxError    = std::max(_maxError, _maxSquaredErrors[i]);
+	}
+	mReprojectionErrors.rmsError = _numImages > 0 && _numCorners > 0 ? std::sqrt(_totalError / (double(_numImages) * _numCorners)) : 0.0;
+	mReprojectionErrors.maxError = std::sqrt(_maxError);
+	return mReprojectionErrors;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 
-		double _error = cv::norm(mAllChessBoardCorners[i], _projectImagePoints, cv::NORM_L2);
 
-		_totalError += _error*_error;
-		_totalPoints += _numCorners;
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+void CameraCalibratorHelper::getParameters(std::vector<double>& intrinsic, std::vector<double>& distortion) const
+{
+	for (int i = 0; i < mIntrinsicMatrix.rows; i++)
+	{
+		for (int j = 0; j < mIntrinsicMatrix.cols; j++)
+		{
+			intrinsic.emplace_back(mIntrinsicMatrix.at<double>(i, j));
+		}
 	}
 
-	return std::sqrt(_totalError/_totalPoints);
+	for (int m = 0; m < mDistortionCoeffs.rows; m++)
+	{
+		for (int n = 0; n < mDistortionCoeffs.cols; n++)
+		{
+			distortion.emplace_back(mDistortionCoeffs.at<double>(m, n));
+		}
+	}
+}
+
+void CameraCalibratorHelper::getDebugParameters(double& coveragePercentage, double& lastRmsError) const
+{
+	coveragePercentage = mCoveragePercentage;
+	lastRmsError       = mLastRmsError;
+}
+
+void CameraCalibratorHelper::getDetectionCacheStatistics(int& numHits, int& numMisses) const
+{
+	numHits   = mDetectionCache ? mDetectionCache->numHits()   : 0;
+	numMisses = mDetectionCache ? mDetectionCache->numMisses() : 0;
 }
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 
@@ -203,6 +1078,13 @@ void CameraCalibratorHelper::saveParameters(nlohmann::json* json, const std::str
 	(*json)[prefix + "DistortionCoeffs"] = _distortionCoeffs;
 	(*json)[prefix + "RmsError"        ] = mLastRmsError;
 	(*json)[prefix + "Coverage"        ] = mCoveragePercentage;
+	(*json)[prefix + "NumDroppedViews" ] = mNumDroppedViews;
+	(*json)[prefix + "ViewRmsErrors"   ] = mReprojectionErrors.viewErrors;
+	(*json)[prefix + "MaxCornerError"  ] = mReprojectionErrors.maxError;
+	if(!mUncertainty.is_null())
+	{
+		(*json)[prefix + "Uncertainty"] = mUncertainty;
+	}
 }
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 
@@ -225,9 +1107,18 @@ void CameraCalibratorHelper::initializeCameraParameters()
 
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 #if defined(RVISIONLIB_HAVE_QT)
+	// The image shares the pooled buffer without a copy and holds a reference to it, which is released by the cleanup 
+	// function when the last copy of the image is destroyed. The image can be passed to other threads.
 	QImage CameraCalibratorHelper::displayImage() const
 	{
-		QImage _image((uchar*)mDisplayImage.data, mDisplayImage.cols, mDisplayImage.rows, QImage::Format_RGB888);
+		const cv::Mat& _displayImage = renderDisplayImage();
+		if(_displayImage.empty())
+		{
+			return QImage();
+		}
+
+		QImage _image((const uchar*)_displayImage.data, _displayImage.cols, _displayImage.rows, int(_displayImage.step), QImage::Format_RGB888,
+		              [](void* buffer) {delete static_cast<cv::Mat*>(buffer);}, new cv::Mat(_displayImage));
 		return _image;
 	}
 #endif
@@ -235,9 +1126,281 @@ void CameraCalibratorHelper::initializeCameraParameters()
 
 
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Level 0 of the pyramid is the input image, every following level has half the resolution.
+std::vector<cv::Mat> CameraCalibratorHelper::_buildPyramid(const cv::Mat& inputImage, std::vector<double>* levelTimesMS) const
+{
+	const int            _numLevels = _numPyramidLevels(inputImage.size());
+	std::vector<cv::Mat> _pyramid(1, inputImage);
+	if(levelTimesMS)
+	{
+		levelTimesMS->assign(_numLevels + 1, 0.0);
+	}
+
+	for(int i=1 ; i<=_numLevels ; ++i)
+	{
+		auto _startTime = std::chrono::high_resolution_clock::now();
+		cv::Mat _resizedImage;
+		cv::resize(_pyramid.back(), _resizedImage, cv::Size(), 0.5, 0.5, cv::INTER_LINEAR_EXACT);
+		_pyramid.push_back(_resizedImage);
+		if(levelTimesMS)
+		{
+			auto _endTime = std::chrono::high_resolution_clock::now();
+			(*levelTimesMS)[i] += std::chrono::duration<double, std::milli>(_endTime - _startTime).count();
+		}
+	}
+	return _pyramid;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// The number of times the input image is halved before the fast chessboard check. Halving stops before the image 
+// becomes narrower than the target width or before the largest possible chessboard square becomes too small. The 
+// square size is estimated for a board filling the image, findChessboardCorners() falls back to finer levels for 
+// smaller boards.
+int CameraCalibratorHelper::_numPyramidLevels(const cv::Size& imageSize) const
+{
+	const int _targetWidth   = mConfiguration.pyramidTargetWidth();
+	const int _minSquareSize = mConfiguration.pyramidMinSquareSize();
+	if(_targetWidth <= 0 && _minSquareSize <= 0)
+	{
+		return 1;
+	}
+
+	int _width      = imageSize.width;
+	int _squareSize = std::min(imageSize.width / (mConfiguration.boardWidth() + 1), imageSize.height / (mConfiguration.boardHeight() + 1));
+	int _numLevels  = 0;
+	while(_width / 2 >= _targetWidth && _squareSize / 2 >= _minSquareSize && _width / 2 > 0)
+	{
+		_width      /= 2;
+		_squareSize /= 2;
+		_numLevels++;
+	}
+	return _numLevels;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Map corners found on the coarsest pyramid level to the input image. Each finer level refines the corners with 
+// a short search using a small window. The input image then gets the same refinement used after full detection.
+std::vector<cv::Point2f> CameraCalibratorHelper::_refineCoarseCorners(const std::vector<cv::Mat>&     pyramid, 
+	                                                                  const std::vector<cv::Point2f>& coarseCorners, 
+	                                                                  std::vector<double>*            levelTimesMS) const
+{
+	cv::TermCriteria _coarseTermCriteria = cv::TermCriteria(cv::TermCriteria::EPS + cv::TermCriteria::COUNT, 10, 0.5);
+	cv::TermCriteria _termCriteria       = cv::TermCriteria(cv::TermCriteria::EPS + cv::TermCriteria::COUNT, 30, 0.1);
+
+	std::vector<cv::Point2f> _corners = coarseCorners;
+	for(int _level = int(pyramid.size()) - 2 ; _level>=0 ; --_level)
+	{
+		auto _startTime = std::chrono::high_resolution_clock::now();
+
+		// Pixel centres are at +0.5 in both levels.
+		const double _scaleX = double(pyramid[_level].cols) / double(pyramid[_level + 1].cols);
+		const double _scaleY = double(pyramid[_level].rows) / double(pyramid[_level + 1].rows);
+		for(cv::Point2f& _corner : _corners)
+		{
+			_corner = cv::Point2f(float((_corner.x + 0.5) * _scaleX - 0.5), float((_corner.y + 0.5) * _scaleY - 0.5));
+		}
+
+		cv::cornerSubPix(pyramid[_level], _corners, cv::Size(5, 5), cv::Size(-1, -1), _coarseTermCriteria);
+		if(_level == 0)
+		{
+			cv::cornerSubPix(pyramid[_level], _corners, cv::Size(11, 11), cv::Size(-1, -1), _termCriteria);
+		}
+
+		if(levelTimesMS)
+		{
+			auto _endTime = std::chrono::high_resolution_clock::now();
+			(*levelTimesMS)[_level] += std::chrono::duration<double, std::milli>(_endTime - _startTime).count();
+		}
+	}
+	
+	return _corners;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+void CameraCalibratorHelper::_updateDetectionQuality(ChessboardDetection* detection) const
+{
+	if(!detection->corners.empty())
+	{
+		detection->status = CameraCalibrationStatus::ImageAccepted;
+
+		const size_t _width  = mConfiguration.boardWidth();
+		const size_t _height = mConfiguration.boardHeight();
+		const std::vector<cv::Point2f>& _corners = detection->corners;
+
+		std::vector<cv::Point2f> _outline = {_corners[0], _corners[_width - 1], _corners[_height * _width - 1], _corners[(_height - 1) * _width]};
+		detection->boardArea = cv::contourArea(_outline) / (double(detection->imageSize.height) * double(detection->imageSize.width));
+
+		double _totalDistance = 0;
+		size_t _numDistances  = 0;
+		for(size_t i = 0 ; i<_height ; ++i)
+		{
+			for(size_t j = 0 ; j<_width ; ++j)
+			{
+				if(j + 1 < _width)  {_totalDistance += cv::norm(_corners[i*_width + j] - _corners[i*_width + j + 1]);   _numDistances++;}
+				if(i + 1 < _height) {_totalDistance += cv::norm(_corners[i*_width + j] - _corners[(i+1)*_width + j]); _numDistances++;}
+			}
+		}
+		detection->squareSize = _numDistances > 0 ? _totalDistance / _numDistances : 0;
+	}
+	else
+	{
+		detection->status = CameraCalibrationStatus::ImageRejected;
+	}
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Move the tracked corners to the new image without running the chessboard detector. The predicted corners are 
+// refined from the coarsest pyramid level, where the motion is smallest, down to the input image. The video module 
+// which provides calcOpticalFlowPyrLK is not part of the bundled libraries, but the chessboard corners are saddle 
+// points which cornerSubPix follows just as well.
+std::vector<cv::Point2f> CameraCalibratorHelper::_propagateCorners(const cv::Mat& inputImage, std::vector<double>* levelTimesMS) const
+{
+	const std::vector<cv::Mat> _pyramid      = _buildPyramid(inputImage, levelTimesMS);
+	const cv::Mat&             _coarseImage  = _pyramid.back();
+	const double               _scaleX       = double(_coarseImage.cols) / double(inputImage.cols);
+	const double               _scaleY       = double(_coarseImage.rows) / double(inputImage.rows);
+	
+	std::vector<cv::Point2f> _predictedCorners;
+	std::vector<cv::Point2f> _corners;
+	for(const cv::Point2f& _trackedCorner : mTrackedCorners)
+	{
+		const cv::Point2f _corner = _trackedCorner + mTrackedVelocity;
+		_predictedCorners.push_back(_corner);
+		_corners.emplace_back(float((_corner.x + 0.5) * _scaleX - 0.5), float((_corner.y + 0.5) * _scaleY - 0.5));
+	}
+
+	auto _startTime = std::chrono::high_resolution_clock::now();
+	cv::TermCriteria _termCriteria = cv::TermCriteria(cv::TermCriteria::EPS + cv::TermCriteria::COUNT, 10, 0.1);
+	cv::cornerSubPix(_coarseImage, _corners, cv::Size(5, 5), cv::Size(-1, -1), _termCriteria);
+	if(levelTimesMS)
+	{
+		auto _endTime = std::chrono::high_resolution_clock::now();
+		levelTimesMS->back() += std::chrono::duration<double, std::milli>(_endTime - _startTime).count();
+	}
+
+	if(_pyramid.size() > 1)
+	{
+		_corners = _refineCoarseCorners(_pyramid, _corners, levelTimesMS);
+	}
+	else
+	{
+		cv::cornerSubPix(inputImage, _corners, cv::Size(11, 11), cv::Size(-1, -1), cv::TermCriteria(cv::TermCriteria::EPS + cv::TermCriteria::COUNT, 30, 0.1));
+	}
+
+	// A corner which moved by half a square from the prediction may have jumped to its neighbour.
+	const size_t             _width      = mConfiguration.boardWidth();
+	const size_t             _height     = mConfiguration.boardHeight();
+	std::vector<cv::Point2f> _outline    = {mTrackedCorners[0], mTrackedCorners[_width - 1], mTrackedCorners[_height * _width - 1], mTrackedCorners[(_height - 1) * _width]};
+	const double             _squareSize = std::sqrt(cv::contourArea(_outline) / double(std::max<size_t>(1, (_width - 1) * (_height - 1))));
+	const cv::Rect2f _imageRect(0.0f, 0.0f, float(inputImage.cols), float(inputImage.rows));
+	for(size_t i=0 ; i<_corners.size() ; ++i)
+	{
+		if(!_imageRect.contains(_corners[i]) || cv::norm(_corners[i] - _predictedCorners[i]) > 0.5 * _squareSize)
+		{
+			return std::vector<cv::Point2f>();
+		}
+	}
+
+	if(!_verifyChessboardGeometry(_corners))
+	{
+		return std::vector<cv::Point2f>();
+	}
+	return _corners;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Check that every corner lies close to the middle of its neighbours along rows and columns. This rejects corners 
+// which are off the grid line or unevenly spaced while allowing perspective and lens distortion across the board.
+bool CameraCalibratorHelper::_verifyChessboardGeometry(const std::vector<cv::Point2f>& corners) const
+{
+	const int   _width        = mConfiguration.boardWidth();
+	const int   _height       = mConfiguration.boardHeight();
+	const float _maxDeviation = 0.15f; // Of the distance between the neighbours.
+
+	if(corners.size() != size_t(_width) * size_t(_height))
+	{
+		return false;
+	}
+
+	auto _isValid = [&](const cv::Point2f& previous, const cv::Point2f& current, const cv::Point2f& next)
+	{
+		const float _distance = float(cv::norm(next - previous));
+		return _distance > 0 && cv::norm(previous + next - 2 * current) < 2 * _maxDeviation * _distance;
+	};
+
+	for(int i = 0 ; i<_height ; ++i)
+	{
+		for(int j = 0 ; j<_width ; ++j)
+		{
+			const cv::Point2f& _corner = corners[i*_width + j];
+			if(j > 0 && j + 1 < _width && !_isValid(corners[i*_width + j - 1], _corner, corners[i*_width + j + 1]))
+			{
+				return false;
+			}
+			if(i > 0 && i + 1 < _height && !_isValid(corners[(i-1)*_width + j], _corner, corners[(i+1)*_width + j]))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// The bounding box of the tracked chessboard moved by the last shift and expanded by the configured margin.
+cv::Rect CameraCalibratorHelper::_predictTrackingRoi(const cv::Size& imageSize) const
+{
+	cv::Rect2f _box = cv::boundingRect(mTrackedCorners);
+	_box.x += mTrackedVelocity.x;
+	_box.y += mTrackedVelocity.y;
+
+	// The margin must leave room for the white border around the outer corners.
+	const float _margin = float(mConfiguration.trackingRoiMargin()) * std::max(_box.width, _box.height);
+	_box.x      -= _margin;
+	_box.y      -= _margin;
+	_box.width  += 2 * _margin;
+	_box.height += 2 * _margin;
+
+	cv::Rect _roi(cv::Point(cvFloor(_box.x), cvFloor(_box.y)), cv::Point(cvCeil(_box.x + _box.width), cvCeil(_box.y + _box.height)));
+	return _roi & cv::Rect(cv::Point(0, 0), imageSize);
+}
+cv::Point2f CameraCalibratorHelper::_centroid(const std::vector<cv::Point2f>& corners)
+{
+	cv::Point2f _sum(0, 0);
+	for(const cv::Point2f& _corner : corners)
+	{
+		_sum += _corner;
+	}
+	return _sum / float(corners.size());
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// The board is rasterized into a buffer the size of its bounding box, and only the pixels it covers for the first time 
+// are counted, so the cost depends on the size of the board and not on the size of the image.
 void CameraCalibratorHelper::_updateCoverageMask(const std::vector<cv::Point2f>& corners)
 {
-	if(!mCoverageMask.empty())
+	if(!mCoverageGrid.empty())
+	{
+		size_t _width = mConfiguration.boardWidth();
+		size_t _height = mConfiguration.boardHeight();
+
+		_updateCoverageGrid({corners[0], corners[_width - 1], corners[_height * _width - 1], corners[(_height - 1) * _width]});
+	}
+	else if(!mCoverageMask.empty())
 	{
 		size_t _width = mConfiguration.boardWidth();
 		size_t _height = mConfiguration.boardHeight();
@@ -248,10 +1411,71 @@ void CameraCalibratorHelper::_updateCoverageMask(const std::vector<cv::Point2f>&
 		_points.emplace_back(corners[_height * _width - 1]);
 		_points.emplace_back(corners[(_height - 1) * _width]);
 
-		cv::fillPoly(mCoverageMask, _points, cv::Scalar(0));
-		mCoveragePercentage = 1.0 - (cv::countNonZero(mCoverageMask) / (double(mCoverageMask.rows) * double(mCoverageMask.cols)));
+		const cv::Rect _boundingBox = cv::boundingRect(_points) & cv::Rect(0, 0, mCoverageMask.cols, mCoverageMask.rows);
+		if(_boundingBox.empty())
+		{
+			return;
+		}
+
+		cv::Mat _board(_boundingBox.size(), CV_8UC1, cv::Scalar(0));
+		cv::fillPoly(_board, _points, cv::Scalar(255), cv::LINE_8, 0, -_boundingBox.tl());
+
+		cv::Mat _coverage        = mCoverageMask(_boundingBox);
+		int64_t _numNewlyCovered = 0;
+		for(int y = 0 ; y<_board.rows ; ++y)
+		{
+			const uchar* _boardRow    = _board.ptr<uchar>(y);
+			uchar*       _coverageRow = _coverage.ptr<uchar>(y);
+
+			// Skip to the span of the scanline covered by the board.
+			int _first = 0;
+			int _last  = _board.cols - 1;
+			while(_first <= _last && !_boardRow[_first]) {++_first;}
+			while(_last >= _first && !_boardRow[_last])  {--_last;}
+			for(int x = _first ; x<=_last ; ++x)
+			{
+				const int _isNewlyCovered = (_boardRow[x] != 0) & (_coverageRow[x] != 0);
+				_numNewlyCovered += _isNewlyCovered;
+				_coverageRow[x]   = _isNewlyCovered ? 0 : _coverageRow[x];
+			}
+		}
+
+		mNumCoveredPixels  += _numNewlyCovered;
+		mCoveragePercentage = double(mNumCoveredPixels) / (double(mCoverageMask.rows) * double(mCoverageMask.cols));
 	}
 }
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// A cell is covered by the board if its centre lies inside the board quad. Only the cells under the bounding box of the 
+// quad are tested, and the coverage is the fraction of cells seen by at least one view.
+void CameraCalibratorHelper::_updateCoverageGrid(const std::vector<cv::Point2f>& quad)
+{
+	const double _cellWidth  = double(mInputImageSize.width)  / mCoverageGrid.cols;
+	const double _cellHeight = double(mInputImageSize.height) / mCoverageGrid.rows;
+
+	const cv::Rect   _boundingBox = cv::boundingRect(quad);
+	const int        _firstCol    = std::max(int(std::floor(_boundingBox.x / _cellWidth)), 0);
+	const int        _lastCol     = std::min(int(std::ceil(_boundingBox.br().x / _cellWidth)), mCoverageGrid.cols - 1);
+	const int        _firstRow    = std::max(int(std::floor(_boundingBox.y / _cellHeight)), 0);
+	const int        _lastRow     = std::min(int(std::ceil(_boundingBox.br().y / _cellHeight)), mCoverageGrid.rows - 1);
+
+	for(int y = _firstRow ; y<=_lastRow ; ++y)
+	{
+		int* _gridRow = mCoverageGrid.ptr<int>(y);
+		for(int x = _firstCol ; x<=_lastCol ; ++x)
+		{
+			const cv::Point2f _centre(float((x + 0.5) * _cellWidth), float((y + 0.5) * _cellHeight));
+			if(cv::pointPolygonTest(quad, _centre, false) >= 0)
+			{
+				++_gridRow[x];
+			}
+		}
+	}
+
+	mCoveragePercentage = double(cv::countNonZero(mCoverageGrid)) / double(mCoverageGrid.total());
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
 }; // end namespace RCamera.
@@ -2,6 +2,7 @@
 #ifndef _RVISION_CAMERA_CAMERACALIBRATORHELPER_H_
 #define _RVISION_CAMERA_CAMERACALIBRATORHELPER_H_
 
+#include "AbstractCameraCalibrator.h"
 #include "CalibratorConfiguration.h"
 
 #include "nlohmann/json.hpp"
@@ -10,32 +11,91 @@
 #if defined(RVISIONLIB_HAVE_QT)
 	#include <QtGui/QImage>
 #endif
+#include <functional>
+#include <memory>
 #include <string>
+#include <vector>
 
 
 namespace RCamera {
 ;
 
+class DetectionCache;
+class DisplayBufferPool;
+
+// The ChessboardDetection struct holds the result of finding chessboard corners in a single image. 
+// It doesn't reference any calibrator state, so it can be created on any thread and added to a calibrator later.
+struct ChessboardDetection
+{
+	CameraCalibrationStatus  status = CameraCalibrationStatus::ImageRejected; // ImageAccepted if the chessboard was found.
+	cv::Mat                  image;                                           // The 8 bit image used for detection. Empty if the input was invalid.
+	cv::Size                 imageSize;                                       // The size of the input image.
+	std::vector<cv::Point2f> corners;                                         // The chessboard corners, empty if the chessboard was not found.
+	double                   boardArea       = 0;                             // The fraction of the image covered by the chessboard.
+	double                   squareSize      = 0;                             // The mean distance between neighbouring corners in pixels.
+	double                   detectionTimeMS = 0;                             // The time taken to find the chessboard corners.
+	std::vector<double>      levelTimesMS;                                    // The detection time spent on each pyramid level, level 0 is the input image.
+	bool                     isCached        = false;                         // True if the corners were loaded from the detection cache.
+	double                   sharpness       = 0;                             // The Laplacian variance of the downsampled image, 0 if not measured.
+	double                   saturation      = 0;                             // The fraction of saturated pixels in the downsampled image.
+};
+
+
+// The ReprojectionErrors struct holds the differences between the projected and detected chessboard corners after 
+// calibration. The buffers are owned by the CameraCalibratorHelper and reused by every calculation.
+struct ReprojectionErrors
+{
+	double              rmsError = 0; // The RMS error over all corners of all views.
+	double              maxError = 0; // The largest error of a single corner.
+	std::vector<double> viewErrors;   // The RMS error of each view.
+	cv::Mat             residuals;    // Projected minus detected corners, one row per view and one CV_32FC2 element per corner.
+};
+
+
 struct CameraCalibratorHelper
 {
 public:
 
+	// Projects the chessboard corners of a view with the camera model of the calibrator.
+	typedef std::function<void(int view, const std::vector<cv::Point3f>& objectPoints, std::vector<cv::Point2f>* projectedPoints)> ProjectionFunction;
+
 	CameraCalibratorHelper();
 	explicit CameraCalibratorHelper(const CalibratorConfiguration& parameters);
 	
 	bool                     checkImageSize(int width, int height);
+	bool                     convertImage(const unsigned char* imageData, int width, int height, int bytesPerPixel, int numRowbytes, cv::Mat* image) const;
 	void                     createCoverageMask(int width, int height);
-	std::vector<cv::Point2f> findChessboardCorners(const cv::Mat& inputImage) const;
+	std::vector<cv::Point2f> findChessboardCorners(const cv::Mat& inputImage, std::vector<double>* levelTimesMS = nullptr) const;
+	ChessboardDetection      detectChessboard(const cv::Mat& inputImage) const;
+	ChessboardDetection      detectChessboard(const unsigned char* imageData, int width, int height, int bytesPerPixel, int numRowbytes) const;
+	std::vector<ChessboardDetection> findChessboardCornersBatch(const std::vector<cv::Mat>& inputImages) const;
+	ChessboardDetection      trackChessboard(const cv::Mat& inputImage);
+	ChessboardDetection      trackChessboard(const unsigned char* imageData, int width, int height, int bytesPerPixel, int numRowbytes);
+	bool                     checkImageQuality(const cv::Mat& inputImage, ChessboardDetection* detection) const;
 	void                     updateCorners(const cv::Mat& inputImage, std::vector<cv::Point2f> _corners);
-	void                     updateDisplayImage(const cv::Mat& inputImage);
-	void                     drawChessboardCorners(const std::vector<cv::Point2f>& corners);
+	CameraCalibrationStatus  addDetection(const ChessboardDetection& detection, int* numImagesAdded, int* numImagesAccepted);
+	bool                     isBatchComplete(int numImagesAccepted) const;
+	void                     addView(const ChessboardDetection& detection);
+	void                     removeViews(std::vector<size_t> viewIndices);
+	std::vector<size_t>      selectViews(size_t numViews) const;
+	void                     setDisplayImage(const cv::Mat& inputImage, const std::vector<cv::Point2f>& corners = {});
+	const cv::Mat&           renderDisplayImage() const;
+	cv::Mat                  coverageOverlay() const;
+	static void              tintGrayImage(const cv::Mat& grayImage, const cv::Mat& tint, cv::Mat* rgbImage);
 	void                     saveChessboardCorners(int imageIndex, const std::string& cameraStr = "");
 
 	std::vector<cv::Point3f> calculateChessboard3DCornerPositions() const;
-	double                   calculateReprojectionErrors(const std::vector<std::vector<cv::Point3f>>& allChessBoard3DCornerPositions,
-		                                                 const std::vector<cv::Mat>&                  rotationVectors,
-		                                                 const std::vector<cv::Mat>&                  translationVectors) const;
+	const ReprojectionErrors& calculateReprojectionErrors(const std::vector<std::vector<cv::Point3f>>& allChessBoard3DCornerPositions,
+		                                                  const std::vector<cv::Mat>&                  rotationVectors,
+		                                                  const std::vector<cv::Mat>&                  translationVectors,
+		                                                  const std::vector<size_t>*                   viewIndices = nullptr);
+	const ReprojectionErrors& calculateReprojectionErrors(const std::vector<std::vector<cv::Point3f>>& allChessBoard3DCornerPositions,
+		                                                  const ProjectionFunction&                    projectView,
+		                                                  const std::vector<size_t>*                   viewIndices = nullptr);
 	void                     saveParameters(nlohmann::json* json, const std::string& prefix) const;
+	void                     getParameters(std::vector<double>& intrinsic, std::vector<double>& distortion) const;
+	void                     getDebugParameters(double& coveragePercentage, double& lastRmsError) const;
+	void                     getDetectionCacheStatistics(int& numHits, int& numMisses) const;
 	void                     initializeCameraParameters();
 
 
@@ -46,7 +106,22 @@ public:
 
 private:
 	
-	void _updateCoverageMask(const std::vector<cv::Point2f>& corners);
+	std::vector<cv::Point2f> _findChessboardCornersSB(const cv::Mat& inputImage, std::vector<double>* levelTimesMS) const;
+	void                     _updateDetectionQuality(ChessboardDetection* detection) const;
+	cv::Rect                 _predictTrackingRoi(const cv::Size& imageSize) const;
+	std::vector<cv::Point2f> _propagateCorners(const cv::Mat& inputImage, std::vector<double>* levelTimesMS) const;
+	bool                     _verifyChessboardGeometry(const std::vector<cv::Point2f>& corners) const;
+	std::vector<cv::Mat>     _buildPyramid(const cv::Mat& inputImage, std::vector<double>* levelTimesMS) const;
+	static cv::Point2f       _centroid(const std::vector<cv::Point2f>& corners);
+	int                      _numPyramidLevels(const cv::Size& imageSize) const;
+	std::vector<cv::Point2f> _refineCoarseCorners(const std::vector<cv::Mat>& pyramid, const std::vector<cv::Point2f>& coarseCorners, std::vector<double>* levelTimesMS) const;
+	void                     _updateCoverageMask(const std::vector<cv::Point2f>& corners);
+
+	typedef std::function<void(int view, const std::vector<cv::Point2f>& imagePoints, cv::Point2f* residuals, double* sumSquaredError, double* maxSquaredError)> ResidualFunction;
+	const ReprojectionErrors& _calculateReprojectionErrors(const std::vector<std::vector<cv::Point3f>>& allChessBoard3DCornerPositions,
+		                                                   const std::vector<size_t>* viewIndices, const ResidualFunction& calculateResiduals);
+	void                     _updateCoverageGrid(const std::vector<cv::Point2f>& quad);
+	inline bool              _useCoverageGrid() const {return mConfiguration.coverageGridWidth() > 0 && mConfiguration.coverageGridHeight() > 0;}
 	
 
 public:
@@ -55,13 +130,29 @@ public:
 	cv::Size                              mInputImageSize;       // The size of the input image.
 	cv::Mat                               mIntrinsicMatrix;         // The camera calibration matrix.
 	cv::Mat                               mDistortionCoeffs;     // The camera distortion coefficients.
-	cv::Mat                               mCoverageMask;         // Binary mask used to show the current coverage of chessboard pattern.
-	cv::Mat                               mDisplayImage;         // The last color image showing coverage which can be displayed on UI.
+	cv::Mat                               mCoverageMask;         // Binary mask used to show the current coverage of chessboard pattern, empty if the coverage grid is used.
+	cv::Mat                               mCoverageGrid;         // The number of views covering each cell of the coverage grid (CV_32SC1), empty if the mask is used.
+	mutable cv::Mat                       mDisplayImage;         // The last color image showing coverage which can be displayed on UI, rendered on request.
+	std::shared_ptr<DisplayBufferPool>    mDisplayBufferPool;    // The buffers mDisplayImage is rendered into.
+	mutable bool                          mIsDisplayImageValid;  // False if mDisplayImage must be rendered again before it is used.
+	cv::Mat                               mDisplayGrayImage;     // The last image passed to setDisplayImage().
+	std::vector<cv::Point2f>              mDisplayCorners;       // The chessboard corners drawn on the display image, empty if the image was rejected.
 	double                                mCoveragePercentage;   // The percentage of image covered by chess board pattern so far.
+	int64_t                               mNumCoveredPixels;     // The number of pixels of mCoverageMask covered so far.
 	std::vector<std::vector<cv::Point2f>> mAllChessBoardCorners; // Collection of chessboard corners from all images.
+	std::vector<int>                      mViewIds;              // A unique id for each element of mAllChessBoardCorners, in increasing order.
+	int                                   mNextViewId;           // The id of the next view added by updateCorners().
 	double                                mLastRmsError;         // The RMS error after last time camera was calibrated.
 	bool                                  mCameraParamersValid;  // True if mCameraMatrix and mDistortionCoeffs doesn't contain NAN or INF.
 	std::vector<cv::Mat>                  mAcceptedImages;
+	std::vector<cv::Point2f>              mTrackedCorners;       // The chessboard corners found in the last image passed to trackChessboard().
+	cv::Point2f                           mTrackedVelocity;      // The shift of the chessboard between the last two tracked images.
+	int                                   mNumImagesTracked;     // The number of images tracked since the whole image was last searched.
+	std::shared_ptr<DetectionCache>       mDetectionCache;       // The cache of chessboard detections, null if disabled.
+	int                                   mNumDroppedViews;      // The number of views removed as outliers during calibration.
+	ReprojectionErrors                    mReprojectionErrors;   // The re-projection errors after the last calibration.
+	cv::Mat                               mResidualBuffer;       // Storage for mReprojectionErrors.residuals, sized for the maximum number of images.
+	nlohmann::json                        mUncertainty;          // The standard deviations and confidence intervals of the intrinsics, null if not estimated.
 };
 
 }; // end namespace RCamera
@@ -0,0 +1,161 @@
+
+#include "DetectionCache.h"
+
+#include "fmt/format.h"
+
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+
+namespace RCamera {
+;
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// 64 bit FNV-1a hash.
+static uint64_t _hash(const unsigned char* data, size_t size, uint64_t hash = 14695981039346656037ull)
+{
+	for(size_t i=0 ; i<size ; ++i)
+	{
+		hash ^= data[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+DetectionCache::DetectionCache(const std::string& directory)
+	: mDirectory(directory),
+	  mNumHits(0),
+	  mNumMisses(0)
+{
+	std::error_code _error;
+	std::filesystem::create_directories(mDirectory, _error);
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// The key combines the hash of the pixels with the hash of every configuration field which changes the detection.
+// The image is the one passed to the detector, so the vertical flip is already part of the pixels.
+std::string DetectionCache::createKey(const cv::Mat& image, const CalibratorConfiguration& configuration) const
+{
+	uint64_t _imageHash = _hash(nullptr, 0);
+	for(int i=0 ; i<image.rows ; ++i)
+	{
+		_imageHash = _hash(image.ptr(i), image.cols * image.elemSize(), _imageHash);
+	}
+
+	nlohmann::json _detectionConfiguration =
+	{
+		{"Width"               , image.cols},
+		{"Height"              , image.rows},
+		{"BoardWidth"          , configuration.boardWidth()},
+		{"BoardHeight"         , configuration.boardHeight()},
+		{"CornerRefinement"    , configuration.cornerRefinement()},
+		{"PyramidTargetWidth"  , configuration.pyramidTargetWidth()},
+		{"PyramidMinSquareSize", configuration.pyramidMinSquareSize()},
+		{"DetectorBackend"     , configuration.detectorBackend()},
+		{"DetectorExhaustive"  , configuration.detectorExhaustive()},
+		{"DetectorAccuracy"    , configuration.detectorAccuracy()},
+		{"DetectorLarger"      , configuration.detectorLarger()}
+	};
+	std::string _configuration     = _detectionConfiguration.dump();
+	uint64_t    _configurationHash = _hash((const unsigned char*)_configuration.data(), _configuration.size());
+
+	return fmt::format("{:016x}_{:016x}", _imageHash, _configurationHash);
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Load the corners and quality of a cached detection. The image of the detection is not changed.
+bool DetectionCache::load(const std::string& key, ChessboardDetection* detection) const
+{
+	try
+	{
+		std::ifstream _stream(_fileName(key));
+		if(_stream)
+		{
+			nlohmann::json j = nlohmann::json::parse(_stream);
+
+			std::vector<float> _corners = j.at("Corners");
+			detection->corners.clear();
+			for(size_t i=0 ; i+1<_corners.size() ; i+=2)
+			{
+				detection->corners.emplace_back(_corners[i], _corners[i + 1]);
+			}
+
+			detection->status     = j.at("Status");
+			detection->imageSize  = cv::Size(j.at("Width"), j.at("Height"));
+			detection->boardArea  = j.at("BoardArea");
+			detection->squareSize = j.at("SquareSize");
+			detection->isCached   = true;
+			
+			mNumHits++;
+			return true;
+		}
+	}
+	catch(const std::exception&)
+	{
+		// A damaged entry is treated like a missing one and overwritten by the next save().
+	}
+
+	mNumMisses++;
+	return false;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+void DetectionCache::save(const std::string& key, const ChessboardDetection& detection) const
+{
+	std::vector<float> _corners;
+	for(const cv::Point2f& _corner : detection.corners)
+	{
+		_corners.emplace_back(_corner.x);
+		_corners.emplace_back(_corner.y);
+	}
+
+	nlohmann::json j =
+	{
+		{"Status"    , detection.status},
+		{"Width"     , detection.imageSize.width},
+		{"Height"    , detection.imageSize.height},
+		{"BoardArea" , detection.boardArea},
+		{"SquareSize", detection.squareSize},
+		{"Corners"   , _corners}
+	};
+
+	// Write to a temporary file first, so that other threads never read a partially written entry.
+	std::string _fileName    = this->_fileName(key);
+	std::string _tmpFileName = fmt::format("{}.{}.tmp", _fileName, std::hash<std::thread::id>()(std::this_thread::get_id()));
+	{
+		std::ofstream _file(_tmpFileName);
+		if(!_file)
+		{
+			return;
+		}
+		_file << j.dump();
+	}
+
+	std::error_code _error;
+	std::filesystem::rename(_tmpFileName, _fileName, _error);
+	if(_error)
+	{
+		std::filesystem::remove(_tmpFileName, _error);
+	}
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+std::string DetectionCache::_fileName(const std::string& key) const
+{
+	return (std::filesystem::path(mDirectory) / (key + ".json")).string();
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+}; // end namespace RCamera.
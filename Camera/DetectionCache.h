@@ -0,0 +1,48 @@
+
+#ifndef _RVISION_CAMERA_DETECTIONCACHE_H_
+#define _RVISION_CAMERA_DETECTIONCACHE_H_
+
+#include "CalibratorConfiguration.h"
+#include "CameraCalibratorHelper.h"
+
+#include "opencv2/core.hpp"
+
+#include <atomic>
+#include <string>
+
+
+namespace RCamera {
+;
+
+// The DetectionCache class stores chessboard detections on disk, so that images don't need to be searched again when 
+// only the solver settings change. Entries are keyed by the image content and the configuration used for detection.
+// All functions can be called from multiple threads.
+class DetectionCache
+{
+public:
+
+	explicit DetectionCache(const std::string& directory);
+
+	std::string createKey(const cv::Mat& image, const CalibratorConfiguration& configuration) const;
+	bool        load(const std::string& key, ChessboardDetection* detection) const;
+	void        save(const std::string& key, const ChessboardDetection& detection) const;
+
+	inline int  numHits()   const {return mNumHits;}
+	inline int  numMisses() const {return mNumMisses;}
+
+
+private:
+
+	std::string _fileName(const std::string& key) const;
+
+
+private:
+
+	std::string              mDirectory;  // The directory containing one JSON file per cached detection.
+	mutable std::atomic<int> mNumHits;    // The number of detections loaded from the cache.
+	mutable std::atomic<int> mNumMisses;  // The number of detections not found in the cache.
+};
+
+}; // end namespace RCamera
+
+#endif // _RVISION_CAMERA_DETECTIONCACHE_H_
@@ -0,0 +1,45 @@
+#include "DisplayBufferPool.h"
+
+
+namespace RCamera {
+;
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+DisplayBufferPool::DisplayBufferPool(int maxNumBuffers)
+	: mMaxNumBuffers(maxNumBuffers)
+{
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Return a free buffer of the requested size and type. Buffers of another size are replaced, because the image size 
+// only changes when a new calibration starts.
+cv::Mat DisplayBufferPool::acquire(const cv::Size& size, int type)
+{
+	std::lock_guard<std::mutex> _lock(mMutex);
+
+	for(cv::Mat& _buffer : mBuffers)
+	{
+		// The reference count is decremented atomically by the thread releasing the buffer.
+		if(CV_XADD(&_buffer.u->refcount, 0) == 1)
+		{
+			if(_buffer.size() != size || _buffer.type() != type)
+			{
+				_buffer = cv::Mat(size, type);
+			}
+			return _buffer;
+		}
+	}
+
+	cv::Mat _buffer(size, type);
+	if(int(mBuffers.size()) < mMaxNumBuffers)
+	{
+		mBuffers.push_back(_buffer);
+	}
+	return _buffer;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+}; // end namespace RCamera.
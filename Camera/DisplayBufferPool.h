@@ -0,0 +1,38 @@
+
+#ifndef _RVISION_CAMERA_DISPLAYBUFFERPOOL_H_
+#define _RVISION_CAMERA_DISPLAYBUFFERPOOL_H_
+
+#include "opencv2/core.hpp"
+
+#include <mutex>
+#include <vector>
+
+
+namespace RCamera {
+;
+
+// The DisplayBufferPool class hands out image buffers for display images which are reused once nobody else holds them. 
+// A buffer is free again when the pool has the only reference to it, so an image returned to the UI keeps its buffer 
+// alive until the UI releases it and the next display image is never drawn into it. At most maxNumBuffers buffers are 
+// kept; if all of them are in use, a buffer outside the pool is returned. All functions can be called from multiple threads.
+class DisplayBufferPool
+{
+public:
+
+	explicit DisplayBufferPool(int maxNumBuffers);
+
+	cv::Mat acquire(const cv::Size& size, int type);
+
+	inline int maxNumBuffers() const {return mMaxNumBuffers;}
+
+
+private:
+
+	std::mutex           mMutex;
+	std::vector<cv::Mat> mBuffers;       // The pooled buffers, each referenced by the pool and by anyone it was handed to.
+	int                  mMaxNumBuffers; // The largest number of buffers kept in the pool.
+};
+
+}; // end namespace RCamera
+
+#endif // _RVISION_CAMERA_DISPLAYBUFFERPOOL_H_
@@ -0,0 +1,201 @@
+#include "FisheyeCameraCalibrator.h"
+
+#include "fmt/format.h"
+#include "opencv2/calib3d.hpp"
+
+#include <iostream>
+#include <chrono>
+#include <cfloat>
+#include <algorithm>
+
+
+namespace RCamera {
+;
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+FisheyeCameraCalibrator::FisheyeCameraCalibrator()
+	: FisheyeCameraCalibrator(CalibratorConfiguration())
+{
+}
+FisheyeCameraCalibrator::FisheyeCameraCalibrator(const CalibratorConfiguration& configuration)
+	: AbstractCameraCalibrator(configuration),
+	  mHelper(configuration)
+{
+	_warnIgnoredOptions();
+}
+FisheyeCameraCalibrator::~FisheyeCameraCalibrator()
+{
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+CameraCalibrationStatus FisheyeCameraCalibrator::setImage(const unsigned char* imageData, int width, int height, int bytesPerPixel, int numRowbytes)
+{
+	if(imageData)
+	{
+		// Images passed to setImage() are sequential, so the chessboard can be tracked from the previous image.
+		return addDetection(mHelper.trackChessboard(imageData, width, height, bytesPerPixel, numRowbytes));
+	}
+	else
+	{
+		// Passing in a null image forces camera calibration without RMS or coverage check.
+		return _calibrateCamera() ? CameraCalibrationStatus::Calibrated : CameraCalibrationStatus::CalibrationFailed;
+	}
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+ChessboardDetection FisheyeCameraCalibrator::detect(const unsigned char* imageData, int width, int height, int bytesPerPixel, int numRowbytes) const
+{
+	return mHelper.detectChessboard(imageData, width, height, bytesPerPixel, numRowbytes);
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+CameraCalibrationStatus FisheyeCameraCalibrator::addDetection(const ChessboardDetection& detection)
+{
+	const CameraCalibrationStatus _status = mHelper.addDetection(detection, &mNumImagesAdded, &mNumImagesAccepted);
+	if(_status != CameraCalibrationStatus::ImageAccepted || !mHelper.isBatchComplete(mNumImagesAccepted))
+	{
+		return _status;
+	}
+
+	if(_calibrateCamera() && mHelper.mLastRmsError < mConfiguration.maxRmsError())
+	{
+		if(mConfiguration.drawChessboardCorners() && mConfiguration.saveOnlyLastChessboardImage())
+		{
+			mHelper.saveChessboardCorners(mHelper.mNextViewId, "");
+		}
+
+		return CameraCalibrationStatus::Calibrated;
+	}
+	return CameraCalibrationStatus::ImageAccepted;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+void FisheyeCameraCalibrator::saveParametersToJSON(nlohmann::json* json) const
+{
+	// Create empty object.
+	(*json)["FisheyeCameraParameters"] =
+	{
+	};
+
+	mHelper.saveParameters(&(*json)["FisheyeCameraParameters"], "");
+	(*json)["FisheyeCameraParameters"]["CameraModel"] = CameraModel::Fisheye;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+void FisheyeCameraCalibrator::setConfiguration(const CalibratorConfiguration& configuration)
+{
+	mHelper = CameraCalibratorHelper(configuration);
+	AbstractCameraCalibrator::setConfiguration(configuration);
+	_warnIgnoredOptions();
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+void FisheyeCameraCalibrator::getParameters(std::vector<double>& intrinsic, std::vector<double>& distortion) const
+{
+	mHelper.getParameters(intrinsic, distortion);
+}
+
+void FisheyeCameraCalibrator::getDebugParameters(double& coveragePercentage, double& lastRmsError) const
+{
+	mHelper.getDebugParameters(coveragePercentage, lastRmsError);
+}
+
+void FisheyeCameraCalibrator::getDetectionCacheStatistics(int& numHits, int& numMisses) const
+{
+	mHelper.getDetectionCacheStatistics(numHits, numMisses);
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+bool FisheyeCameraCalibrator::_calibrateCamera()
+{
+	const int              _calibrationFlag = mConfiguration.fisheyeCalibrationFlag();
+	const cv::TermCriteria _criteria(cv::TermCriteria::COUNT + cv::TermCriteria::EPS, 100, DBL_EPSILON);
+
+	std::vector<cv::Point3f>              _chessBoard3DCornerPositions = mHelper.calculateChessboard3DCornerPositions();
+	std::vector<std::vector<cv::Point3f>> _allChessBoard3DCornerPositions(mNumImagesAccepted, _chessBoard3DCornerPositions);
+
+	// cv::fisheye::calibrate() initialises the intrinsics itself, the focal length from the vanishing points of the
+	// chessboards and the principal point at the image centre.
+	std::vector<cv::Vec3d> _rotationVectors;
+	std::vector<cv::Vec3d> _translationVectors;
+	cv::Mat                _intrinsicMatrix;
+	cv::Mat                _distortionCoeffs;
+	auto _startTime = std::chrono::high_resolution_clock::now();
+	try
+	{
+		mHelper.mLastRmsError = cv::fisheye::calibrate(_allChessBoard3DCornerPositions, mHelper.mAllChessBoardCorners, mHelper.mInputImageSize,
+		                                               _intrinsicMatrix, _distortionCoeffs, _rotationVectors, _translationVectors,
+		                                               _calibrationFlag, _criteria);
+	}
+	catch(const cv::Exception& e)
+	{
+		std::cout << fmt::format("Fisheye calibration failed: {}\n", e.what());
+		mHelper.mCameraParamersValid = false;
+		return false;
+	}
+	auto _endTime = std::chrono::high_resolution_clock::now();
+	double _timeMS = std::chrono::duration_cast<std::chrono::milliseconds>(_endTime - _startTime).count();
+
+	mHelper.mIntrinsicMatrix  = _intrinsicMatrix;
+	mHelper.mDistortionCoeffs = _distortionCoeffs;
+
+	std::cout << fmt::format("Time taken for fisheye calibration: {}\n", _timeMS);
+	std::cout << fmt::format("Re-projection Error={:.5f}, Coverage={:.3f}\n", mHelper.mLastRmsError, mHelper.mCoveragePercentage);
+	std::cout << fmt::format("Calibration Flag is ={:1d}\n",_calibrationFlag);
+
+	// The pinhole projection of the helper doesn't apply, so the views are projected with cv::fisheye::projectPoints().
+	const ReprojectionErrors& _errors = mHelper.calculateReprojectionErrors(_allChessBoard3DCornerPositions, 
+		[&](int view, const std::vector<cv::Point3f>& objectPoints, std::vector<cv::Point2f>* projectedPoints)
+	{
+		cv::fisheye::projectPoints(objectPoints, *projectedPoints, _rotationVectors[view], _translationVectors[view], 
+		                           mHelper.mIntrinsicMatrix, mHelper.mDistortionCoeffs);
+	});
+	if(!_errors.viewErrors.empty())
+	{
+		const auto _worstView = std::max_element(_errors.viewErrors.begin(), _errors.viewErrors.end());
+		std::cout << fmt::format("Worst view is {} with re-projection error {:.5f}, largest corner error is {:.5f}\n",
+		                         _worstView - _errors.viewErrors.begin(), *_worstView, _errors.maxError);
+	}
+	std::cout << "Distortion Coeff   are "<< mHelper.mDistortionCoeffs << "\n";
+	std::cout << "Camera Matrix are "<< mHelper.mIntrinsicMatrix << "\n";
+
+	mHelper.mCameraParamersValid = cv::checkRange(mHelper.mIntrinsicMatrix) && cv::checkRange(mHelper.mDistortionCoeffs);
+	return mHelper.mCameraParamersValid;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// The options of the pinhole calibration have no fisheye counterpart, say so instead of silently dropping them.
+void FisheyeCameraCalibrator::_warnIgnoredOptions() const
+{
+	std::vector<std::string> _options;
+	if(mConfiguration.calibWarmStart())                                 {_options.push_back("CalibWarmStart");}
+	if(mConfiguration.calibrationSolver() != CalibrationSolver::OpenCV) {_options.push_back("CalibrationSolver");}
+	if(mConfiguration.calibOutlierRejection())                          {_options.push_back("CalibOutlierRejection");}
+	if(mConfiguration.bootstrapSamples() > 0)                           {_options.push_back("BootstrapSamples");}
+	if(mConfiguration.viewSelectionSize() > 0)                          {_options.push_back("ViewSelectionSize");}
+	if(mConfiguration.backgroundCalibration())                          {_options.push_back("BackgroundCalibration");}
+
+	for(const std::string& _option : _options)
+	{
+		std::cout << fmt::format("Warning: {} is not supported by the fisheye camera model and is ignored\n", _option);
+	}
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+}; // end namespace RCamera.
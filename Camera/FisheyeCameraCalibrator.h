@@ -0,0 +1,67 @@
+
+#ifndef _RVISION_CAMERA_FISHEYECAMERACALIBRATOR_
+#define _RVISION_CAMERA_FISHEYECAMERACALIBRATOR_
+
+#include "AbstractCameraCalibrator.h"
+#include "CameraCalibratorHelper.h"
+
+
+namespace RCamera {
+;
+
+// The FisheyeCameraCalibrator class calibrates wide-angle lenses with the equidistant model of cv::fisheye. Detection,
+// tracking and coverage are the same as in MonoCameraCalibrator, the distortion coefficients are k1, k2, k3 and k4.
+// Every batch is solved by cv::fisheye::calibrate() in the calling thread, so CalibWarmStart, CalibrationSolver, 
+// CalibOutlierRejection, BootstrapSamples, ViewSelectionSize and BackgroundCalibration are ignored.
+class FisheyeCameraCalibrator : public AbstractCameraCalibrator
+{
+public:
+
+	FisheyeCameraCalibrator();
+	explicit FisheyeCameraCalibrator(const CalibratorConfiguration& configuration);
+	~FisheyeCameraCalibrator();
+
+
+	// Set next image for calibration.
+	CameraCalibrationStatus setImage(const unsigned char* image, int width, int height, int bytesPerPixel, int numRowbytes);
+
+	// Find chessboard corners in an image without changing the state of the calibrator. This function is reentrant,
+	// so any number of threads can call it for the same calibrator while another thread adds detections.
+	ChessboardDetection detect(const unsigned char* image, int width, int height, int bytesPerPixel, int numRowbytes) const;
+
+	// Add a detection returned by detect() for calibration. Detections must be added from one thread at a time.
+	CameraCalibrationStatus addDetection(const ChessboardDetection& detection);
+
+
+	void saveParametersToJSON(nlohmann::json* json) const override;
+	void setConfiguration(const CalibratorConfiguration& configuration) override;
+	void getParameters(std::vector<double>& intrinsic, std::vector<double>& distortion) const;
+	void getDebugParameters(double& coveragePercentage, double& lastRmsError) const;
+	void getDetectionCacheStatistics(int& numHits, int& numMisses) const;
+
+	inline int numDroppedViews() const {return mHelper.mNumDroppedViews;}
+
+	// The number of accepted views covering each cell of the coverage grid, empty if CoverageGridWidth is 0.
+	inline const cv::Mat& coverageGrid() const {return mHelper.mCoverageGrid;}
+
+
+	#if defined(RVISIONLIB_HAVE_QT)
+		inline QImage displayImage() const {return mHelper.displayImage();}
+	#endif
+
+
+private:
+
+
+	bool _calibrateCamera();
+	void _warnIgnoredOptions() const;
+
+
+private:
+
+	CameraCalibratorHelper mHelper;
+};
+
+}; // end namespace RCamera
+
+#endif // _RVISION_CAMERA_FISHEYECAMERACALIBRATOR_
@@ -1,5 +1,7 @@
 
 #include "MonoCameraCalibrator.h"
+#include "CalibrationExecutor.h"
+#include "SparseCalibrationSolver.h"
 
 #include "fmt/format.h"
 #include "opencv2/calib3d.hpp"
@@ -7,11 +9,23 @@
 
 #include <iostream>
 #include <chrono>
+#include <cfloat>
+#include <algorithm>
+#include <numeric>
 
 
 namespace RCamera {
 ;
 
+// The BackgroundCalibration struct holds the state shared by a calibrator and the calibrations it runs in the background.
+struct BackgroundCalibration
+{
+	std::mutex                                      mutex;
+	std::shared_ptr<MonoCameraCalibrator>           result;   // The last finished calibration, null once taken over.
+	MonoCameraCalibrator::CalibrationCallback       callback;
+	CalibrationExecutor                             executor; // Declared last, so its thread is joined before the other members are destroyed.
+};
+
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 MonoCameraCalibrator::MonoCameraCalibrator()
 	: MonoCameraCalibrator(CalibratorConfiguration())
@@ -19,7 +33,8 @@ MonoCameraCalibrator::MonoCameraCalibrator()
 }
 MonoCameraCalibrator::MonoCameraCalibrator(const CalibratorConfiguration& configuration)
 	: AbstractCameraCalibrator(configuration), 
-	  mHelper(configuration)
+	  mHelper(configuration),
+	  mIsCancelled(nullptr)
 {
 }
 MonoCameraCalibrator::~MonoCameraCalibrator()
@@ -46,88 +61,49 @@ CameraCalibrationStatus MonoCameraCalibrator::setImage(const unsigned char* imag
 
 	if(imageData)
 	{
-		cv::Mat _image;
-		if(bytesPerPixel == 1)
-		{
-			_image = cv::Mat(mHelper.mInputImageSize, CV_8UC1, (void*)imageData, numRowbytes);
-		}
-		else if(bytesPerPixel == 2)
-		{
-			_image = cv::Mat(mHelper.mInputImageSize, CV_16UC1, (void*)imageData, numRowbytes);
-			_image.convertTo(_image, CV_8UC1, 1.0/256.0);
-		}
-		else
-		{
-			return CameraCalibrationStatus::InvalidBytesPerPixel;
-		}
-		
-		mNumImagesAdded++;
-
-		// If this is the first image, create coverage mask.
-		mHelper.createCoverageMask(width, height);
-		
-		if(mConfiguration.flipVertically())
+		// Images passed to setImage() are sequential, so the chessboard can be tracked from the previous image.
+		return addDetection(mHelper.trackChessboard(imageData, width, height, bytesPerPixel, numRowbytes));
+	}
+	else
+	{
+		// Passing in a null image forces camera calibration without RMS or coverage check.
+		if(_calibrateCamera())
 		{
-			cv::flip(_image, _image, 0);
+			_estimateUncertainty();
+			return CameraCalibrationStatus::Calibrated;
 		}
+		return CameraCalibrationStatus::CalibrationFailed;
+	}
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 
-		std::vector<cv::Point2f> _corners = mHelper.findChessboardCorners(_image);
-		if(!_corners.empty())
-		{
-			mHelper.mAcceptedImages.push_back(_image.clone());
-			mNumImagesAccepted++;
 
-			if(mConfiguration.drawAcceptedImage())
-			{
-				std::string _fileName = fmt::format("{}{:04d}.png", mConfiguration.acceptedImageFilePrefix(), mNumImagesAccepted);
-				cv::imwrite(_fileName, _image);
-			}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+ChessboardDetection MonoCameraCalibrator::detect(const unsigned char* imageData, int width, int height, int bytesPerPixel, int numRowbytes) const
+{
+	return mHelper.detectChessboard(imageData, width, height, bytesPerPixel, numRowbytes);
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 
-			// The following order of functions must not be changed.
-			mHelper.updateCorners(_image, _corners);
-			mHelper.updateDisplayImage(_image);
-			mHelper.drawChessboardCorners(_corners);
 
-			if(mConfiguration.drawChessboardCorners() && !mConfiguration.saveOnlyLastChessboardImage())
-			{
-				mHelper.saveChessboardCorners(mNumImagesAccepted, "");
-			}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+CameraCalibrationStatus MonoCameraCalibrator::addDetection(const ChessboardDetection& detection)
+{
+	// Take over the result of a background calibration which finished since the last image.
+	_applyBackgroundCalibration();
 
-			bool b1 = mNumImagesAccepted          >= mConfiguration.minNumImages();
-			bool b2 = mHelper.mCoveragePercentage > mConfiguration.minCoverage();
-			int  b3 = mNumImagesAccepted          % mConfiguration.imageBatchSize();
-			if(b1 && b2 && b3==0)
-			{
-				if(_calibrateCamera() && mHelper.mLastRmsError < mConfiguration.maxRmsError())
-				{
-					if(mConfiguration.drawChessboardCorners() && mConfiguration.saveOnlyLastChessboardImage())
-					{
-						mHelper.saveChessboardCorners(mNumImagesAccepted, "");
-					}
-
-					return CameraCalibrationStatus::Calibrated;
-				}
-				else
-				{
-					return CameraCalibrationStatus::ImageAccepted;
-				}
-			}
-			else
-			{
-				return CameraCalibrationStatus::ImageAccepted;
-			}
-		}
-		else
-		{
-			mHelper.updateDisplayImage(_image);
-			return CameraCalibrationStatus::ImageRejected;
-		}
+	const CameraCalibrationStatus _status = mHelper.addDetection(detection, &mNumImagesAdded, &mNumImagesAccepted);
+	if(_status != CameraCalibrationStatus::ImageAccepted || !mHelper.isBatchComplete(mNumImagesAccepted))
+	{
+		return _status;
 	}
-	else
+
+	if(mConfiguration.backgroundCalibration())
 	{
-		// Passing in a null image forces camera calibration without RMS or coverage check.
-		return _calibrateCamera() ? CameraCalibrationStatus::Calibrated : CameraCalibrationStatus::CalibrationFailed;
+		_startBackgroundCalibration();
+		return CameraCalibrationStatus::ImageAccepted;
 	}
+	return _calibrateBatch();
 }
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 
@@ -148,6 +124,14 @@ void MonoCameraCalibrator::saveParametersToJSON(nlohmann::json* json) const
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 void MonoCameraCalibrator::setConfiguration(const CalibratorConfiguration& configuration)
 {
+	// A calibration of the previous images must not be taken over.
+	if(mBackground)
+	{
+		mBackground->executor.wait();
+		std::lock_guard<std::mutex> _lock(mBackground->mutex);
+		mBackground->result = nullptr;
+	}
+
 	mHelper = CameraCalibratorHelper(configuration);
 	AbstractCameraCalibrator::setConfiguration(configuration);
 }
@@ -155,29 +139,19 @@ void MonoCameraCalibrator::setConfiguration(const CalibratorConfiguration& confi
 
 
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
-void MonoCameraCalibrator::getParameters(std::vector<double>& intrinsic, std::vector<double>& distortion)
+void MonoCameraCalibrator::getParameters(std::vector<double>& intrinsic, std::vector<double>& distortion) const
 {
-	for (int i = 0; i < mHelper.mIntrinsicMatrix.rows; i++)
-	{
-		for (int j = 0; j < mHelper.mIntrinsicMatrix.cols; j++)
-		{
-			intrinsic.emplace_back(mHelper.mIntrinsicMatrix.at<double>(i, j));
-		}
-	}
+	mHelper.getParameters(intrinsic, distortion);
+}
 
-	for (int m = 0; m < mHelper.mDistortionCoeffs.rows; m++)
-	{
-		for (int n = 0; n < mHelper.mDistortionCoeffs.cols; n++)
-		{
-			distortion.emplace_back(mHelper.mDistortionCoeffs.at<double>(m, n));
-		}
-	}
+void MonoCameraCalibrator::getDebugParameters(double& coveragePercentage, double& lastRmsError) const
+{
+	mHelper.getDebugParameters(coveragePercentage, lastRmsError);
 }
 
-void MonoCameraCalibrator::getDebugParameters(double& coveragePercentage, double& lastRmsError)
+void MonoCameraCalibrator::getDetectionCacheStatistics(int& numHits, int& numMisses) const
 {
-	coveragePercentage = mHelper.mCoveragePercentage;
-	lastRmsError = mHelper.mLastRmsError;
+	mHelper.getDetectionCacheStatistics(numHits, numMisses);
 }
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 
@@ -185,28 +159,461 @@ void MonoCameraCalibrator::getDebugParameters(double& coveragePercentage, double
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 bool MonoCameraCalibrator::_calibrateCamera()
 {
-	mHelper.initializeCameraParameters();
-	int _calibrationFlag = mConfiguration.calibrationFlag();
+	int              _calibrationFlag = mConfiguration.calibrationFlag();
+	cv::TermCriteria _criteria(cv::TermCriteria::COUNT + cv::TermCriteria::EPS, 30, DBL_EPSILON);
+
+	// A warm start refines the previous intrinsics instead of solving from scratch. Only one batch of images was added 
+	// since, so the solution is close and the solver stops once the relative parameter change is below the tolerance.
+	// calibrateCamera() has no way to pass in previous extrinsics, they are initialised from the homography of each view.
+	const bool _warmStart = mConfiguration.calibWarmStart() && mHelper.mCameraParamersValid;
+	if(_warmStart)
+	{
+		_calibrationFlag  |= cv::CALIB_USE_INTRINSIC_GUESS;
+		_criteria.epsilon  = mConfiguration.calibWarmStartTolerance();
+	}
+	else
+	{
+		mHelper.initializeCameraParameters();
+	}
 	
+	// Solve only on the most informative views when there are more than needed. The others are redundant and only slow 
+	// down the solver, but they stay accepted, so later solves can select them and they still count for coverage.
+	std::vector<size_t> _views(mHelper.mAllChessBoardCorners.size());
+	std::iota(_views.begin(), _views.end(), size_t(0));
+	const size_t _viewSelectionSize = size_t(std::max(mConfiguration.viewSelectionSize(), 0));
+	if(_viewSelectionSize > 0 && _views.size() > _viewSelectionSize)
+	{
+		_views = mHelper.selectViews(_viewSelectionSize);
+		std::cout << fmt::format("Selected {} of {} views by pose and coverage\n", _views.size(), mHelper.mAllChessBoardCorners.size());
+	}
+	auto _selectedCorners = [&]()
+	{
+		std::vector<std::vector<cv::Point2f>> _corners;
+		_corners.reserve(_views.size());
+		for(size_t i : _views)
+		{
+			_corners.push_back(mHelper.mAllChessBoardCorners[i]);
+		}
+		return _corners;
+	};
+
 	std::vector<cv::Point3f>              _chessBoard3DCornerPositions = mHelper.calculateChessboard3DCornerPositions();
-	std::vector<std::vector<cv::Point3f>> _allChessBoard3DCornerPositions(mNumImagesAccepted, _chessBoard3DCornerPositions);
+	std::vector<std::vector<cv::Point3f>> _allChessBoard3DCornerPositions(_views.size(), _chessBoard3DCornerPositions);
 
 	// Find intrinsic and extrinsic camera parameters	
 	std::vector<cv::Mat> _rotationVectors;
 	std::vector<cv::Mat> _translationVectors;
+	std::vector<double>  _perViewErrors;
 	auto _startTime = std::chrono::high_resolution_clock::now();
-	mHelper.mLastRmsError = cv::calibrateCamera(_allChessBoard3DCornerPositions, mHelper.mAllChessBoardCorners, mHelper.mInputImageSize,
-		                                        mHelper.mIntrinsicMatrix, mHelper.mDistortionCoeffs, _rotationVectors, _translationVectors, _calibrationFlag);
+	mHelper.mLastRmsError = _solveCamera(_calibrationFlag, _criteria, _allChessBoard3DCornerPositions, _selectedCorners(), 
+	                                     &mHelper.mIntrinsicMatrix, &mHelper.mDistortionCoeffs, &_rotationVectors, &_translationVectors, &_perViewErrors);
+
+	// Drop outlying views and solve again from the current parameters until no more views are dropped.
+	if(mConfiguration.calibOutlierRejection())
+	{
+		while(!_isCancelled() && cv::checkRange(mHelper.mIntrinsicMatrix) && cv::checkRange(mHelper.mDistortionCoeffs) && _dropOutlierViews(_perViewErrors, &_views) > 0)
+		{
+			_allChessBoard3DCornerPositions.resize(_views.size());
+			mHelper.mLastRmsError = _solveCamera(_calibrationFlag | cv::CALIB_USE_INTRINSIC_GUESS, _criteria, _allChessBoard3DCornerPositions, _selectedCorners(), 
+			                                     &mHelper.mIntrinsicMatrix, &mHelper.mDistortionCoeffs, &_rotationVectors, &_translationVectors, &_perViewErrors);
+		}
+	}
 	auto _endTime = std::chrono::high_resolution_clock::now();
 	double _timeMS = std::chrono::duration_cast<std::chrono::milliseconds>(_endTime - _startTime).count();
 
-	std::cout << fmt::format("Time taken for calibration: {}\n", _timeMS);
+	if(_isCancelled())
+	{
+		std::cout << fmt::format("Calibration of {} views cancelled after {} ms\n", _views.size(), _timeMS);
+		return false;
+	}
+
+	std::cout << fmt::format("Time taken for calibration: {}{}\n", _timeMS, _warmStart ? " (warm start)" : "");
 	std::cout << fmt::format("Re-projection Error={:.5f}, Coverage={:.3f}\n", mHelper.mLastRmsError, mHelper.mCoveragePercentage);
 	std::cout << fmt::format("Calibration Flag is ={:1d}\n",_calibrationFlag);
+
+	// Report the re-projection errors of every view.
+	const ReprojectionErrors& _errors = mHelper.calculateReprojectionErrors(_allChessBoard3DCornerPositions, _rotationVectors, _translationVectors, &_views);
+	if(!_errors.viewErrors.empty())
+	{
+		const auto _worstView = std::max_element(_errors.viewErrors.begin(), _errors.viewErrors.end());
+		std::cout << fmt::format("Worst view is {} with re-projection error {:.5f}, largest corner error is {:.5f}\n", 
+		                         _views[_worstView - _errors.viewErrors.begin()], *_worstView, _errors.maxError);
+	}
 	std::cout << "Distortion Coeff   are "<< mHelper.mDistortionCoeffs << "\n";
 	std::cout << "Camera Matrix are "<< mHelper.mIntrinsicMatrix << "\n";
 
-	return cv::checkRange(mHelper.mIntrinsicMatrix) && cv::checkRange(mHelper.mDistortionCoeffs);
+	mHelper.mCameraParamersValid = cv::checkRange(mHelper.mIntrinsicMatrix) && cv::checkRange(mHelper.mDistortionCoeffs);
+	return mHelper.mCameraParamersValid;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Calibrate the camera when a batch of images is complete. Returns Calibrated if the RMS error is small enough.
+CameraCalibrationStatus MonoCameraCalibrator::_calibrateBatch()
+{
+	if(_calibrateCamera() && mHelper.mLastRmsError < mConfiguration.maxRmsError())
+	{
+		_estimateUncertainty();
+
+		if(mConfiguration.drawChessboardCorners() && mConfiguration.saveOnlyLastChessboardImage())
+		{
+			mHelper.saveChessboardCorners(mHelper.mNextViewId, "");
+		}
+
+		return CameraCalibrationStatus::Calibrated;
+	}
+	else
+	{
+		return CameraCalibrationStatus::ImageAccepted;
+	}
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+void MonoCameraCalibrator::setCalibrationCallback(const CalibrationCallback& callback)
+{
+	if(!mBackground)
+	{
+		mBackground = std::make_shared<BackgroundCalibration>();
+	}
+
+	std::lock_guard<std::mutex> _lock(mBackground->mutex);
+	mBackground->callback = callback;
+}
+
+void MonoCameraCalibrator::waitForBackgroundCalibration()
+{
+	if(mBackground)
+	{
+		mBackground->executor.wait();
+		_applyBackgroundCalibration();
+	}
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Calibrate a copy of this calibrator on the background thread. The copy owns everything the calibration changes, so 
+// images can be added while it runs. A calibration which is cancelled by a newer batch is discarded.
+void MonoCameraCalibrator::_startBackgroundCalibration()
+{
+	if(!mBackground)
+	{
+		mBackground = std::make_shared<BackgroundCalibration>();
+	}
+
+	auto _snapshot = std::make_shared<MonoCameraCalibrator>(*this);
+	_snapshot->mBackground                  = nullptr;
+	_snapshot->mHelper.mCoverageMask        = mHelper.mCoverageMask.clone();
+	_snapshot->mHelper.mCoverageGrid        = mHelper.mCoverageGrid.clone();
+	_snapshot->mHelper.mIntrinsicMatrix     = mHelper.mIntrinsicMatrix.clone();
+	_snapshot->mHelper.mDistortionCoeffs    = mHelper.mDistortionCoeffs.clone();
+	_snapshot->mHelper.mDisplayImage        = cv::Mat();
+	_snapshot->mHelper.mIsDisplayImageValid = false;
+	_snapshot->mHelper.mResidualBuffer      = cv::Mat();
+	_snapshot->mHelper.mReprojectionErrors  = ReprojectionErrors();
+
+	BackgroundCalibration* _background = mBackground.get();
+	_background->executor.submit([_snapshot, _background](const std::atomic<bool>& isCancelled)
+	{
+		_snapshot->mIsCancelled = &isCancelled;
+		const CameraCalibrationStatus _status = _snapshot->_calibrateBatch();
+		_snapshot->mIsCancelled = nullptr;
+		if(isCancelled)
+		{
+			return;
+		}
+
+		CalibrationCallback _callback;
+		{
+			std::lock_guard<std::mutex> _lock(_background->mutex);
+			_background->result = _snapshot;
+			_callback           = _background->callback;
+		}
+		if(_callback)
+		{
+			_callback(_status, *_snapshot);
+		}
+	});
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Take over the parameters of the last finished background calibration. Views it dropped as outliers are removed, 
+// views added since it started are kept.
+void MonoCameraCalibrator::_applyBackgroundCalibration()
+{
+	if(!mBackground)
+	{
+		return;
+	}
+
+	std::shared_ptr<MonoCameraCalibrator> _result;
+	{
+		std::lock_guard<std::mutex> _lock(mBackground->mutex);
+		_result = std::move(mBackground->result);
+		mBackground->result = nullptr;
+	}
+	if(!_result)
+	{
+		return;
+	}
+
+	const CameraCalibratorHelper& _solved = _result->mHelper;
+	mHelper.mIntrinsicMatrix     = _solved.mIntrinsicMatrix.clone();
+	mHelper.mDistortionCoeffs    = _solved.mDistortionCoeffs.clone();
+	mHelper.mLastRmsError        = _solved.mLastRmsError;
+	mHelper.mCameraParamersValid = _solved.mCameraParamersValid;
+	mHelper.mNumDroppedViews     = _solved.mNumDroppedViews;
+	mHelper.mReprojectionErrors  = _solved.mReprojectionErrors;
+	mHelper.mUncertainty         = _solved.mUncertainty;
+
+	std::vector<size_t> _removed;
+	for(size_t i = 0 ; i<mHelper.mViewIds.size() ; ++i)
+	{
+		const int _id = mHelper.mViewIds[i];
+		if(_id < _solved.mNextViewId && !std::binary_search(_solved.mViewIds.begin(), _solved.mViewIds.end(), _id))
+		{
+			_removed.push_back(i);
+		}
+	}
+	mHelper.removeViews(_removed);
+	mNumImagesAccepted -= int(_removed.size());
+}
+
+bool MonoCameraCalibrator::_isCancelled() const
+{
+	return mIsCancelled && *mIsCancelled;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+double MonoCameraCalibrator::_solveCamera(int                                          calibrationFlag, 
+	                                      const cv::TermCriteria&                      criteria, 
+	                                      const std::vector<std::vector<cv::Point3f>>& allChessBoard3DCornerPositions,
+	                                      const std::vector<std::vector<cv::Point2f>>& allChessBoardCorners,
+	                                      cv::Mat*                                     intrinsicMatrix, 
+	                                      cv::Mat*                                     distortionCoeffs, 
+	                                      std::vector<cv::Mat>*                        rotationVectors, 
+	                                      std::vector<cv::Mat>*                        translationVectors, 
+	                                      std::vector<double>*                         perViewErrors) const
+{
+	if(mConfiguration.calibrationSolver() == CalibrationSolver::SparseLM)
+	{
+		SparseCalibrationSolver _solver(calibrationFlag, criteria);
+		_solver.setCancelFlag(mIsCancelled);
+		const double _rmsError = _solver.calibrate(allChessBoard3DCornerPositions, allChessBoardCorners, mHelper.mInputImageSize,
+		                                           *intrinsicMatrix, *distortionCoeffs, *rotationVectors, *translationVectors);
+		*perViewErrors = _solver.perViewErrors();
+		return _rmsError;
+	}
+	else
+	{
+		cv::Mat      _perViewErrors;
+		const double _rmsError = cv::calibrateCamera(allChessBoard3DCornerPositions, allChessBoardCorners, mHelper.mInputImageSize,
+		                                             *intrinsicMatrix, *distortionCoeffs, *rotationVectors, *translationVectors, 
+		                                             cv::noArray(), cv::noArray(), _perViewErrors, calibrationFlag, criteria);
+		_perViewErrors.reshape(1, 1).copyTo(*perViewErrors);
+		return _rmsError;
+	}
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// A view is an outlier if its error is above the median by more than calibOutlierThreshold robust standard deviations, 
+// estimated as 1.4826 times the median absolute deviation. The worst views are dropped first and at least 
+// minNumImages views are kept. perViewErrors holds the errors of the solved views, whose indices in the helper are in 
+// views. The dropped views are removed from the helper and from views. Returns the number of views dropped.
+int MonoCameraCalibrator::_dropOutlierViews(const std::vector<double>& perViewErrors, std::vector<size_t>* views)
+{
+	const int _numViews = int(perViewErrors.size());
+	if(_numViews <= mConfiguration.minNumImages())
+	{
+		return 0;
+	}
+
+	auto _median = [](std::vector<double> values)
+	{
+		std::nth_element(values.begin(), values.begin() + values.size()/2, values.end());
+		return values[values.size()/2];
+	};
+
+	const double        _medianError = _median(perViewErrors);
+	std::vector<double> _deviations(perViewErrors.size());
+	for(size_t i = 0 ; i<perViewErrors.size() ; ++i)
+	{
+		_deviations[i] = std::abs(perViewErrors[i] - _medianError);
+	}
+	const double _threshold = _medianError + mConfiguration.calibOutlierThreshold() * 1.4826 * _median(_deviations);
+
+	std::vector<size_t> _outliers;
+	for(size_t i = 0 ; i<perViewErrors.size() ; ++i)
+	{
+		if(perViewErrors[i] > _threshold)
+		{
+			_outliers.push_back(i);
+		}
+	}
+	std::sort(_outliers.begin(), _outliers.end(), [&](size_t a, size_t b) {return perViewErrors[a] > perViewErrors[b];});
+	_outliers.resize(std::min<size_t>(_outliers.size(), size_t(_numViews - mConfiguration.minNumImages())));
+
+	std::vector<size_t> _removed;
+	std::vector<char>   _isOutlier(views->size(), false);
+	for(size_t i : _outliers)
+	{
+		std::cout << fmt::format("Dropped view {} with re-projection error {:.3f}, threshold is {:.3f}\n", (*views)[i], perViewErrors[i], _threshold);
+		_removed.push_back((*views)[i]);
+		_isOutlier[i] = true;
+	}
+	std::sort(_removed.begin(), _removed.end());
+
+	// The remaining views move down by the number of removed views before them.
+	std::vector<size_t> _remaining;
+	for(size_t i = 0 ; i<views->size() ; ++i)
+	{
+		if(!_isOutlier[i])
+		{
+			const size_t _view = (*views)[i];
+			_remaining.push_back(_view - size_t(std::lower_bound(_removed.begin(), _removed.end(), _view) - _removed.begin()));
+		}
+	}
+	*views = _remaining;
+
+	mHelper.removeViews(_removed);
+	mHelper.mNumDroppedViews += int(_outliers.size());
+	mNumImagesAccepted       -= int(_outliers.size());
+	return int(_outliers.size());
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Estimate the uncertainty of the intrinsics by calibrating again from views drawn with replacement from the accepted 
+// views. Each resample starts from the final solution and the resamples are solved in parallel.
+void MonoCameraCalibrator::_estimateUncertainty()
+{
+	const int _numSamples = mConfiguration.bootstrapSamples();
+	const int _numViews   = int(mHelper.mAllChessBoardCorners.size());
+	mHelper.mUncertainty  = nullptr;
+	if(_numSamples <= 1 || _numViews < 2 || !mHelper.mCameraParamersValid)
+	{
+		return;
+	}
+
+	const std::vector<std::vector<cv::Point3f>> _allChessBoard3DCornerPositions(_numViews, mHelper.calculateChessboard3DCornerPositions());
+	const int              _calibrationFlag = mConfiguration.calibrationFlag() | cv::CALIB_USE_INTRINSIC_GUESS;
+
+	// The resamples start from the calibrated parameters, so a few iterations to a fixed relative change are enough. 
+	// This is independent of CalibWarmStartTolerance, which only controls the warm start of the batch calibration.
+	const double           _bootstrapTolerance = 1e-5;
+	const cv::TermCriteria _criteria(cv::TermCriteria::COUNT + cv::TermCriteria::EPS, 30, _bootstrapTolerance);
+	const int              _numParameters = 4 + int(mHelper.mDistortionCoeffs.total());
+
+	// One row of fx, fy, cx, cy and the distortion coefficients per resample.
+	cv::Mat           _samples(_numSamples, _numParameters, CV_64F, cv::Scalar(0));
+	std::vector<char> _isValid(_numSamples, false);
+
+	auto _startTime = std::chrono::high_resolution_clock::now();
+	cv::parallel_for_(cv::Range(0, _numSamples), [&](const cv::Range& range)
+	{
+		std::vector<std::vector<cv::Point2f>> _allChessBoardCorners(_numViews);
+		std::vector<cv::Mat>                  _rotationVectors;
+		std::vector<cv::Mat>                  _translationVectors;
+		std::vector<double>                   _perViewErrors;
+		for(int s = range.start ; s<range.end && !_isCancelled() ; ++s)
+		{
+			// Seed each resample by its index, so the result doesn't depend on the number of threads.
+			cv::RNG _rng(0x9E3779B9u + unsigned(s));
+			for(int i = 0 ; i<_numViews ; ++i)
+			{
+				_allChessBoardCorners[i] = mHelper.mAllChessBoardCorners[_rng.uniform(0, _numViews)];
+			}
+
+			cv::Mat _intrinsicMatrix  = mHelper.mIntrinsicMatrix.clone();
+			cv::Mat _distortionCoeffs = mHelper.mDistortionCoeffs.clone();
+			_solveCamera(_calibrationFlag, _criteria, _allChessBoard3DCornerPositions, _allChessBoardCorners, 
+			             &_intrinsicMatrix, &_distortionCoeffs, &_rotationVectors, &_translationVectors, &_perViewErrors);
+			if(!cv::checkRange(_intrinsicMatrix) || !cv::checkRange(_distortionCoeffs) || int(_distortionCoeffs.total()) + 4 != _numParameters)
+			{
+				continue;
+			}
+
+			double* _sample = _samples.ptr<double>(s);
+			_sample[0] = _intrinsicMatrix.at<double>(0, 0);
+			_sample[1] = _intrinsicMatrix.at<double>(1, 1);
+			_sample[2] = _intrinsicMatrix.at<double>(0, 2);
+			_sample[3] = _intrinsicMatrix.at<double>(1, 2);
+			for(int k = 4 ; k<_numParameters ; ++k)
+			{
+				_sample[k] = _distortionCoeffs.at<double>(k - 4);
+			}
+			_isValid[s] = true;
+		}
+	});
+	auto _endTime = std::chrono::high_resolution_clock::now();
+	if(_isCancelled())
+	{
+		return;
+	}
+
+	std::vector<int> _validSamples;
+	for(int s = 0 ; s<_numSamples ; ++s)
+	{
+		if(_isValid[s]) {_validSamples.push_back(s);}
+	}
+	if(_validSamples.size() < 2)
+	{
+		return;
+	}
+
+	// Standard deviation and percentile confidence interval of each parameter.
+	const std::vector<std::string> _names      = {"fx", "fy", "cx", "cy", "k1", "k2", "p1", "p2", "k3", "k4", "k5", "k6", "s1", "s2", "s3", "s4", "tx", "ty"};
+	const double                   _alpha      = 0.5 * (1.0 - mConfiguration.bootstrapConfidence());
+	const size_t                   _numValid   = _validSamples.size();
+	nlohmann::json                 _parameters;
+	for(int k = 0 ; k<_numParameters && k<int(_names.size()) ; ++k)
+	{
+		std::vector<double> _values;
+		for(int s : _validSamples)
+		{
+			_values.push_back(_samples.at<double>(s, k));
+		}
+		std::sort(_values.begin(), _values.end());
+
+		const double _mean     = std::accumulate(_values.begin(), _values.end(), 0.0) / _numValid;
+		double       _variance = 0;
+		for(double v : _values)
+		{
+			_variance += (v - _mean) * (v - _mean);
+		}
+		const double _standardDeviation = std::sqrt(_variance / (_numValid - 1));
+
+		_parameters[_names[k]] =
+		{
+			{"StdDev", _standardDeviation},
+			{"Lower" , _values[size_t(std::floor(_alpha * (_numValid - 1)))]},
+			{"Upper" , _values[size_t(std::ceil((1.0 - _alpha) * (_numValid - 1)))]}
+		};
+	}
+
+	mHelper.mUncertainty =
+	{
+		{"NumSamples" , _numValid},
+		{"Confidence" , mConfiguration.bootstrapConfidence()},
+		{"Parameters" , _parameters}
+	};
+
+	const double _timeMS = std::chrono::duration<double, std::milli>(_endTime - _startTime).count();
+	std::cout << fmt::format("Bootstrap of {} resamples took {:.0f} ms, fx={:.3f}+-{:.3f}, fy={:.3f}+-{:.3f}, cx={:.3f}+-{:.3f}, cy={:.3f}+-{:.3f}\n", 
+	                         _numValid, _timeMS, 
+	                         mHelper.mIntrinsicMatrix.at<double>(0, 0), _parameters["fx"]["StdDev"].get<double>(), 
+	                         mHelper.mIntrinsicMatrix.at<double>(1, 1), _parameters["fy"]["StdDev"].get<double>(),
+	                         mHelper.mIntrinsicMatrix.at<double>(0, 2), _parameters["cx"]["StdDev"].get<double>(), 
+	                         mHelper.mIntrinsicMatrix.at<double>(1, 2), _parameters["cy"]["StdDev"].get<double>());
 }
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 
@@ -5,13 +5,22 @@
 #include "AbstractCameraCalibrator.h"
 #include "CameraCalibratorHelper.h"
 
+#include <atomic>
+#include <functional>
+#include <memory>
+
 
 namespace RCamera {
 ;
 
+struct BackgroundCalibration;
+
 class MonoCameraCalibrator : public AbstractCameraCalibrator
 {
 public:
+
+	// Called with the status of a background calibration and the calibrator holding its result.
+	typedef std::function<void(CameraCalibrationStatus status, const MonoCameraCalibrator& result)> CalibrationCallback;
 	
 	MonoCameraCalibrator();
 	explicit MonoCameraCalibrator(const CalibratorConfiguration& configuration);
@@ -21,11 +30,31 @@ public:
 	// Set next image for calibration.
 	CameraCalibrationStatus setImage(const unsigned char* image, int width, int height, int bytesPerPixel, int numRowbytes);
 
+	// Find chessboard corners in an image without changing the state of the calibrator. This function is reentrant, 
+	// so any number of threads can call it for the same calibrator while another thread adds detections.
+	ChessboardDetection detect(const unsigned char* image, int width, int height, int bytesPerPixel, int numRowbytes) const;
+
+	// Add a detection returned by detect() for calibration. Detections must be added from one thread at a time.
+	CameraCalibrationStatus addDetection(const ChessboardDetection& detection);
+
+	// If backgroundCalibration() is set in the configuration, addDetection() returns ImageAccepted when a batch is 
+	// complete and the camera is calibrated on a background thread from a copy of the corners. A newer batch cancels 
+	// the calibration still running. The callback is called from the background thread, and the result is taken over 
+	// by the next call to addDetection() or waitForBackgroundCalibration().
+	void setCalibrationCallback(const CalibrationCallback& callback);
+	void waitForBackgroundCalibration();
+
 	
 	void saveParametersToJSON(nlohmann::json* json) const override;
 	void setConfiguration(const CalibratorConfiguration& configuration) override;
-	void getParameters(std::vector<double>& intrinsic, std::vector<double>& distortion);
-	void getDebugParameters(double& coveragePercentage, double& lastRmsError);
+	void getParameters(std::vector<double>& intrinsic, std::vector<double>& distortion) const;
+	void getDebugParameters(double& coveragePercentage, double& lastRmsError) const;
+	void getDetectionCacheStatistics(int& numHits, int& numMisses) const;
+
+	inline int numDroppedViews() const {return mHelper.mNumDroppedViews;}
+
+	// The number of accepted views covering each cell of the coverage grid, empty if CoverageGridWidth is 0.
+	inline const cv::Mat& coverageGrid() const {return mHelper.mCoverageGrid;}
 
 
 	#if defined(RVISIONLIB_HAVE_QT)
@@ -36,12 +65,23 @@ public:
 private:
 	
 
-	bool _calibrateCamera();
+	bool   _calibrateCamera();
+	CameraCalibrationStatus _calibrateBatch();
+	void   _startBackgroundCalibration();
+	void   _applyBackgroundCalibration();
+	bool   _isCancelled() const;
+	double _solveCamera(int calibrationFlag, const cv::TermCriteria& criteria, const std::vector<std::vector<cv::Point3f>>& allChessBoard3DCornerPositions,
+	                    const std::vector<std::vector<cv::Point2f>>& allChessBoardCorners, cv::Mat* intrinsicMatrix, cv::Mat* distortionCoeffs,
+	                    std::vector<cv::Mat>* rotationVectors, std::vector<cv::Mat>* translationVectors, std::vector<double>* perViewErrors) const;
+	int    _dropOutlierViews(const std::vector<double>& perViewErrors, std::vector<size_t>* views);
+	void   _estimateUncertainty();
 
 
 private:
 
-	CameraCalibratorHelper mHelper;
+	CameraCalibratorHelper                 mHelper;
+	std::shared_ptr<BackgroundCalibration> mBackground;  // The executor and last result of background calibration, null until used.
+	const std::atomic<bool>*               mIsCancelled; // The cancel flag of the background calibration running on this copy, or null.
 };
 
 }; // end namespace RCamera
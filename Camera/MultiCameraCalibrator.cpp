@@ -0,0 +1,847 @@
+#include "MultiCameraCalibrator.h"
+
+#include "fmt/format.h"
+#include "opencv2/calib3d.hpp"
+#include "opencv2/imgcodecs.hpp"
+
+#include <iostream>
+#include <chrono>
+#include <cfloat>
+#include <algorithm>
+#include <limits>
+
+
+namespace RCamera {
+;
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+MultiCameraCalibrator::MultiCameraCalibrator(int numCameras)
+	: MultiCameraCalibrator(numCameras, CalibratorConfiguration())
+{
+}
+MultiCameraCalibrator::MultiCameraCalibrator(int numCameras, const CalibratorConfiguration& configuration)
+	: AbstractCameraCalibrator(configuration),
+	  mHelpers(std::max(numCameras, 1), CameraCalibratorHelper(configuration)),
+	  mRotations(mHelpers.size()),
+	  mTranslations(mHelpers.size()),
+	  mCameraRmsErrors(mHelpers.size(), 0.0),
+	  mRigRmsError(std::numeric_limits<double>::max())
+{
+}
+MultiCameraCalibrator::~MultiCameraCalibrator()
+{
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+CameraCalibrationStatus MultiCameraCalibrator::setImage(const std::vector<const unsigned char*>& images,
+	                                                    int width, int height, int bytesPerPixel, int numRowbytes)
+{
+	const size_t _numCameras = mHelpers.size();
+
+	// Size of the input images must be same as previously added images.
+	for(CameraCalibratorHelper& _helper : mHelpers)
+	{
+		if(!_helper.checkImageSize(width, height))
+		{
+			return CameraCalibrationStatus::ImageSizeInvalid;
+		}
+	}
+
+	// Don't accept images after the maximum number number of images has been accepted.
+	if(mNumImagesAccepted > mConfiguration.maxNumImages())
+	{
+		return CameraCalibrationStatus::CalibrationFailed;
+	}
+
+
+	if(!images.empty())
+	{
+		// A frame must have one image per camera.
+		if(images.size() != _numCameras)
+		{
+			return CameraCalibrationStatus::ImageSizeInvalid;
+		}
+
+		std::vector<cv::Mat> _images(_numCameras);
+		for(size_t c = 0 ; c<_numCameras ; ++c)
+		{
+			if(!images[c] || !mHelpers[c].convertImage(images[c], width, height, bytesPerPixel, numRowbytes, &_images[c]))
+			{
+				return CameraCalibrationStatus::InvalidBytesPerPixel;
+			}
+		}
+
+		mNumImagesAdded++;
+
+		// If this is the first image, create coverage mask.
+		for(CameraCalibratorHelper& _helper : mHelpers)
+		{
+			_helper.createCoverageMask(width, height);
+		}
+
+		// All helpers have the same configuration, so the first one finds the chessboard in the images of all cameras.
+		const std::vector<ChessboardDetection> _detections = mHelpers[0].findChessboardCornersBatch(_images);
+
+		Frame _frame;
+		_frame.views.assign(_numCameras, -1);
+		bool _isSeen = false;
+		for(const ChessboardDetection& _detection : _detections)
+		{
+			_isSeen = _isSeen || _detection.status == CameraCalibrationStatus::ImageAccepted;
+		}
+		if(!_isSeen)
+		{
+			for(size_t c = 0 ; c<_numCameras ; ++c)
+			{
+				mHelpers[c].setDisplayImage(_images[c]);
+			}
+			return CameraCalibrationStatus::ImageRejected;
+		}
+
+		mNumImagesAccepted++;
+		for(size_t c = 0 ; c<_numCameras ; ++c)
+		{
+			CameraCalibratorHelper&         _helper  = mHelpers[c];
+			const std::vector<cv::Point2f>& _corners = _detections[c].corners;
+			if(_detections[c].status != CameraCalibrationStatus::ImageAccepted)
+			{
+				_helper.setDisplayImage(_images[c]);
+				continue;
+			}
+
+			_frame.views[c] = int(_helper.mAllChessBoardCorners.size());
+			_helper.mAcceptedImages.push_back(_images[c]);
+
+			if(mConfiguration.drawAcceptedImage())
+			{
+				std::string _fileName = fmt::format("{}C{}_{:04d}.png", mConfiguration.acceptedImageFilePrefix(), c, mNumImagesAccepted);
+				cv::imwrite(_fileName, _images[c]);
+			}
+
+			// The following order of functions must not be changed.
+			_helper.updateCorners(_images[c], _corners);
+			_helper.setDisplayImage(_images[c], _corners);
+
+			if(mConfiguration.drawChessboardCorners() && !mConfiguration.saveOnlyLastChessboardImage())
+			{
+				_helper.saveChessboardCorners(mNumImagesAccepted, fmt::format("Camera{}", c));
+			}
+		}
+		mFrames.push_back(_frame);
+
+		bool b1 = true;
+		bool b2 = true;
+		int  b3 = mNumImagesAccepted % mConfiguration.imageBatchSize();
+		for(const CameraCalibratorHelper& _helper : mHelpers)
+		{
+			b1 = b1 && int(_helper.mAllChessBoardCorners.size()) >= mConfiguration.minNumImages();
+			b2 = b2 && _helper.mCoveragePercentage > mConfiguration.minCoverage();
+		}
+		if(b1 && b2 && b3==0)
+		{
+			bool _isCalibrated = _calibrateCamera() && mRigRmsError < mConfiguration.maxRmsError();
+			for(const CameraCalibratorHelper& _helper : mHelpers)
+			{
+				_isCalibrated = _isCalibrated && _helper.mLastRmsError < mConfiguration.maxRmsError();
+			}
+
+			if(_isCalibrated)
+			{
+				if(mConfiguration.drawChessboardCorners() && mConfiguration.saveOnlyLastChessboardImage())
+				{
+					for(size_t c = 0 ; c<_numCameras ; ++c)
+					{
+						mHelpers[c].saveChessboardCorners(mNumImagesAccepted, fmt::format("Camera{}", c));
+					}
+				}
+
+				return CameraCalibrationStatus::Calibrated;
+			}
+			else
+			{
+				return CameraCalibrationStatus::CalibrationFailed;
+			}
+		}
+		else
+		{
+			return CameraCalibrationStatus::ImageAccepted;
+		}
+	}
+	else
+	{
+		// Passing in no images forces camera calibration without RMS or coverage check.
+		return _calibrateCamera() ? CameraCalibrationStatus::Calibrated : CameraCalibrationStatus::CalibrationFailed;
+	}
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+void MultiCameraCalibrator::saveParametersToJSON(nlohmann::json* json) const
+{
+	(*json)["MultiCameraParameters"] =
+	{
+	};
+
+	nlohmann::json* _multiCameraParameters = &(*json)["MultiCameraParameters"];
+
+	auto _toVector = [](const cv::Mat& matrix)
+	{
+		std::vector<double> _values;
+		for(int i = 0 ; i<matrix.rows ; i++)
+		{
+			for(int j = 0 ; j<matrix.cols ; j++)
+			{
+				_values.emplace_back(matrix.at<double>(i, j));
+			}
+		}
+		return _values;
+	};
+
+	const int _numCameras = numCameras();
+	(*_multiCameraParameters)["NumCameras"     ] = _numCameras;
+	(*_multiCameraParameters)["ReferenceCamera"] = 0;
+	(*_multiCameraParameters)["NumFrames"      ] = mFrames.size();
+	(*_multiCameraParameters)["RmsError"       ] = mRigRmsError;
+
+
+	// The intrinsics of each camera and its pose relative to the reference camera.
+	nlohmann::json _cameras = nlohmann::json::array();
+	for(int c = 0 ; c<_numCameras ; ++c)
+	{
+		cv::Matx33d _rotation;
+		cv::Vec3d   _translation;
+		getPose(c, _rotation, _translation);
+
+		nlohmann::json _camera;
+		mHelpers[c].saveParameters(&_camera, "");
+		_camera["RotationMatrix"   ] = _toVector(cv::Mat(_rotation));
+		_camera["TranslationMatrix"] = _toVector(cv::Mat(_translation));
+		_camera["RigRmsError"      ] = mCameraRmsErrors[c];
+		_cameras.push_back(_camera);
+	}
+	(*_multiCameraParameters)["Cameras"] = _cameras;
+
+
+	// The relative pose of every pair of cameras which saw the chessboard in the same frames, x2 = R * x1 + T.
+	const size_t   _numCorners = mChessBoard3DCornerPositions.size();
+	nlohmann::json _pairs      = nlohmann::json::array();
+	for(int c = 0 ; c<_numCameras ; ++c)
+	{
+		for(int d = c + 1 ; d<_numCameras ; ++d)
+		{
+			int    _numCommonFrames = 0;
+			int    _numRigFrames    = 0;
+			double _squaredError    = 0;
+			for(const Frame& _frame : mFrames)
+			{
+				if(_frame.views[c] < 0 || _frame.views[d] < 0)
+				{
+					continue;
+				}
+				_numCommonFrames++;
+				if(_frame.squaredErrors.size() == mHelpers.size())
+				{
+					_squaredError += _frame.squaredErrors[c] + _frame.squaredErrors[d];
+					_numRigFrames++;
+				}
+			}
+			if(_numCommonFrames == 0)
+			{
+				continue;
+			}
+
+			cv::Matx33d _rotation;
+			cv::Vec3d   _translation;
+			_relativePose(c, d, &_rotation, &_translation);
+
+			const cv::Matx33d _translationCross(0, -_translation[2], _translation[1], _translation[2], 0, -_translation[0], -_translation[1], _translation[0], 0);
+			const cv::Matx33d _essential = _translationCross * _rotation;
+			cv::Matx33d       _fundamental;
+			if(mHelpers[c].mCameraParamersValid && mHelpers[d].mCameraParamersValid)
+			{
+				_fundamental = cv::Matx33d(mHelpers[d].mIntrinsicMatrix).inv().t() * _essential * cv::Matx33d(mHelpers[c].mIntrinsicMatrix).inv();
+			}
+
+			_pairs.push_back(
+			{
+				{"First"            , c},
+				{"Second"           , d},
+				{"NumCommonFrames"  , _numCommonFrames},
+				{"RmsError"         , _numRigFrames > 0 && _numCorners > 0 ? std::sqrt(_squaredError / (2.0 * _numRigFrames * _numCorners)) : 0.0},
+				{"RotationMatrix"   , _toVector(cv::Mat(_rotation))},
+				{"TranslationMatrix", _toVector(cv::Mat(_translation))},
+				{"EssentialMatrix"  , _toVector(cv::Mat(_essential))},
+				{"FundamentalMatrix", _toVector(cv::Mat(_fundamental))}
+			});
+		}
+	}
+	(*_multiCameraParameters)["Pairs"] = _pairs;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+void MultiCameraCalibrator::setConfiguration(const CalibratorConfiguration& configuration)
+{
+	const size_t _numCameras = mHelpers.size();
+	mHelpers.assign(_numCameras, CameraCalibratorHelper(configuration));
+	mFrames.clear();
+	mRotations.assign(_numCameras, cv::Vec3d());
+	mTranslations.assign(_numCameras, cv::Vec3d());
+	mCameraRmsErrors.assign(_numCameras, 0.0);
+	mRigRmsError = std::numeric_limits<double>::max();
+	AbstractCameraCalibrator::setConfiguration(configuration);
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+void MultiCameraCalibrator::getParameters(int camera, std::vector<double>& intrinsic, std::vector<double>& distortion) const
+{
+	const CameraCalibratorHelper& _helper = mHelpers[camera];
+	for (int i = 0; i < _helper.mIntrinsicMatrix.rows; i++)
+	{
+		for (int j = 0; j < _helper.mIntrinsicMatrix.cols; j++)
+		{
+			intrinsic.emplace_back(_helper.mIntrinsicMatrix.at<double>(i, j));
+		}
+	}
+
+	for (int m = 0; m < _helper.mDistortionCoeffs.rows; m++)
+	{
+		for (int n = 0; n < _helper.mDistortionCoeffs.cols; n++)
+		{
+			distortion.emplace_back(_helper.mDistortionCoeffs.at<double>(m, n));
+		}
+	}
+}
+
+void MultiCameraCalibrator::getDebugParameters(int camera, double& coverage, double& rmsError) const
+{
+	coverage = mHelpers[camera].mCoveragePercentage;
+	rmsError = mHelpers[camera].mLastRmsError;
+}
+
+void MultiCameraCalibrator::getPose(int camera, cv::Matx33d& rotation, cv::Vec3d& translation) const
+{
+	cv::Rodrigues(mRotations[camera], rotation);
+	translation = mTranslations[camera];
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+bool MultiCameraCalibrator::_calibrateCamera()
+{
+	const size_t _numCameras      = mHelpers.size();
+	const int    _calibrationFlag = mConfiguration.calibrationFlag();
+	mChessBoard3DCornerPositions  = mHelpers[0].calculateChessboard3DCornerPositions();
+
+	// The intrinsics of a camera only depend on its own views, so all cameras are calibrated in parallel.
+	std::vector<std::vector<cv::Mat>> _rotationVectors(_numCameras);
+	std::vector<std::vector<cv::Mat>> _translationVectors(_numCameras);
+	std::vector<std::vector<double>>  _perViewErrors(_numCameras);
+	auto _startTime = std::chrono::high_resolution_clock::now();
+	cv::parallel_for_(cv::Range(0, int(_numCameras)), [&](const cv::Range& range)
+	{
+		for(int c = range.start ; c<range.end ; ++c)
+		{
+			CameraCalibratorHelper& _helper = mHelpers[c];
+			_helper.mCameraParamersValid    = false;
+			if(_helper.mAllChessBoardCorners.empty())
+			{
+				continue;
+			}
+
+			_helper.initializeCameraParameters();
+			const std::vector<std::vector<cv::Point3f>> _allChessBoard3DCornerPositions(_helper.mAllChessBoardCorners.size(), mChessBoard3DCornerPositions);
+			cv::Mat _errors;
+			_helper.mLastRmsError = cv::calibrateCamera(_allChessBoard3DCornerPositions, _helper.mAllChessBoardCorners, _helper.mInputImageSize,
+			                                            _helper.mIntrinsicMatrix, _helper.mDistortionCoeffs, _rotationVectors[c], _translationVectors[c],
+			                                            cv::noArray(), cv::noArray(), _errors, _calibrationFlag);
+			_errors.reshape(1, 1).copyTo(_perViewErrors[c]);
+
+			_helper.mCameraParamersValid = cv::checkRange(_helper.mIntrinsicMatrix) && cv::checkRange(_helper.mDistortionCoeffs);
+			if(_helper.mCameraParamersValid)
+			{
+				_helper.calculateReprojectionErrors(_allChessBoard3DCornerPositions, _rotationVectors[c], _translationVectors[c]);
+			}
+		}
+	});
+	auto _intrinsicsTime = std::chrono::high_resolution_clock::now();
+
+	for(size_t c = 0 ; c<_numCameras ; ++c)
+	{
+		const CameraCalibratorHelper& _helper = mHelpers[c];
+		std::cout << fmt::format("Camera {}: {} views, Re-projection Error={:.5f}, Coverage={:.3f}\n",
+		                         c, _helper.mAllChessBoardCorners.size(), _helper.mLastRmsError, _helper.mCoveragePercentage);
+		if(!_helper.mCameraParamersValid)
+		{
+			std::cout << fmt::format("Camera {} could not be calibrated\n", c);
+			return false;
+		}
+	}
+
+	if(!_initializePoses(_rotationVectors, _translationVectors, _perViewErrors))
+	{
+		return false;
+	}
+	mRigRmsError = _optimizePoses();
+	auto _endTime = std::chrono::high_resolution_clock::now();
+
+	const double _intrinsicsTimeMS = std::chrono::duration<double, std::milli>(_intrinsicsTime - _startTime).count();
+	const double _posesTimeMS      = std::chrono::duration<double, std::milli>(_endTime - _intrinsicsTime).count();
+	std::cout << fmt::format("Time taken for calibration: intrinsics {:.0f} ms, rig poses {:.0f} ms\n", _intrinsicsTimeMS, _posesTimeMS);
+	std::cout << fmt::format("Rig Re-projection Error={:.5f}\n", mRigRmsError);
+	std::cout << fmt::format("Calibration Flag is ={:1d}\n", _calibrationFlag);
+	for(size_t c = 1 ; c<_numCameras ; ++c)
+	{
+		std::cout << fmt::format("Camera {}: rotation [{:.5f}, {:.5f}, {:.5f}], translation [{:.5f}, {:.5f}, {:.5f}], Rig Re-projection Error={:.5f}\n",
+		                         c, mRotations[c][0], mRotations[c][1], mRotations[c][2], 
+		                         mTranslations[c][0], mTranslations[c][1], mTranslations[c][2], mCameraRmsErrors[c]);
+	}
+
+	return cv::checkRange(mRotations) && cv::checkRange(mTranslations) && mRigRmsError < std::numeric_limits<double>::max();
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Find the first estimate of the camera poses from the chessboard poses of the intrinsic calibration. Starting from
+// the reference camera, each camera which shares a frame with a camera already placed is placed through the shared
+// frame with the smallest view errors. The chessboard pose of each frame is taken from its best view.
+bool MultiCameraCalibrator::_initializePoses(const std::vector<std::vector<cv::Mat>>& rotationVectors,
+	                                         const std::vector<std::vector<cv::Mat>>& translationVectors,
+	                                         const std::vector<std::vector<double>>&  perViewErrors)
+{
+	const int _numCameras = numCameras();
+
+	auto _viewPose = [&](const Frame& frame, int camera, cv::Matx33d* rotation, cv::Vec3d* translation)
+	{
+		const int _view = frame.views[camera];
+		cv::Rodrigues(rotationVectors[camera][_view], *rotation);
+		*translation = cv::Vec3d(translationVectors[camera][_view].ptr<double>());
+	};
+
+	std::vector<cv::Matx33d> _rotations(_numCameras, cv::Matx33d::eye());
+	std::vector<cv::Vec3d>   _translations(_numCameras);
+	std::vector<char>        _isPlaced(_numCameras, false);
+	std::vector<int>         _placed = {0};
+	_isPlaced[0] = true;
+	for(size_t i = 0 ; i<_placed.size() ; ++i)
+	{
+		const int c = _placed[i];
+		for(int d = 0 ; d<_numCameras ; ++d)
+		{
+			if(_isPlaced[d])
+			{
+				continue;
+			}
+
+			const Frame* _bestFrame = nullptr;
+			double       _bestError = std::numeric_limits<double>::max();
+			for(const Frame& _frame : mFrames)
+			{
+				if(_frame.views[c] < 0 || _frame.views[d] < 0)
+				{
+					continue;
+				}
+				const double _error = perViewErrors[c][_frame.views[c]] + perViewErrors[d][_frame.views[d]];
+				if(_error < _bestError) {_bestError = _error; _bestFrame = &_frame;}
+			}
+			if(!_bestFrame)
+			{
+				continue;
+			}
+
+			// The chessboard gives x_c = R_c * X + t_c and x_d = R_d * X + t_d, so x_d = R_d * R_c^T * (x_c - t_c) + t_d.
+			cv::Matx33d _rotationC, _rotationD;
+			cv::Vec3d   _translationC, _translationD;
+			_viewPose(*_bestFrame, c, &_rotationC, &_translationC);
+			_viewPose(*_bestFrame, d, &_rotationD, &_translationD);
+			const cv::Matx33d _rotationDC    = _rotationD * _rotationC.t();
+			const cv::Vec3d   _translationDC = _translationD - _rotationDC * _translationC;
+
+			_rotations[d]    = _rotationDC * _rotations[c];
+			_translations[d] = _rotationDC * _translations[c] + _translationDC;
+			_isPlaced[d]     = true;
+			_placed.push_back(d);
+		}
+	}
+
+	for(int c = 0 ; c<_numCameras ; ++c)
+	{
+		if(!_isPlaced[c])
+		{
+			std::cout << fmt::format("Camera {} shares no chessboard view with the reference camera\n", c);
+			return false;
+		}
+		cv::Rodrigues(_rotations[c], mRotations[c]);
+		mTranslations[c] = _translations[c];
+	}
+
+	for(Frame& _frame : mFrames)
+	{
+		int    _bestCamera = -1;
+		double _bestError  = std::numeric_limits<double>::max();
+		for(int c = 0 ; c<_numCameras ; ++c)
+		{
+			if(_frame.views[c] >= 0 && perViewErrors[c][_frame.views[c]] < _bestError)
+			{
+				_bestError  = perViewErrors[c][_frame.views[c]];
+				_bestCamera = c;
+			}
+		}
+
+		cv::Matx33d _rotation;
+		cv::Vec3d   _translation;
+		_viewPose(_frame, _bestCamera, &_rotation, &_translation);
+		cv::Rodrigues(_rotations[_bestCamera].t() * _rotation, _frame.rotation);
+		_frame.translation = _rotations[_bestCamera].t() * (_translation - _translations[_bestCamera]);
+	}
+	return true;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Optimise the poses of all cameras but the reference camera together with the chessboard pose of every frame seen by
+// two or more cameras, with the intrinsics fixed. The normal equations have one 6x6 block per frame, which is
+// eliminated with the Schur complement, so each iteration only solves a system of 6 unknowns per camera.
+// Returns the RMS error over all cameras.
+double MultiCameraCalibrator::_optimizePoses()
+{
+	const int _numCameras = numCameras();
+	const int _numUnknowns = 6 * (_numCameras - 1);
+
+	std::vector<size_t> _rigFrames;
+	size_t              _numObservations = 0;
+	for(size_t f = 0 ; f<mFrames.size() ; ++f)
+	{
+		const int _numViews = int(std::count_if(mFrames[f].views.begin(), mFrames[f].views.end(), [](int v) {return v >= 0;}));
+		if(_numViews >= 2)
+		{
+			_rigFrames.push_back(f);
+			_numObservations += _numViews;
+		}
+	}
+
+	double _error = _buildNormalEquations(_rigFrames);
+	if(_numUnknowns > 0 && !_rigFrames.empty())
+	{
+		const int    _maxIterations = 100;
+		const double _epsilon       = 1e-10;
+		double       _lambda        = 1e-3;
+
+		std::vector<cv::Vec3d> _rotations(_numCameras);
+		std::vector<cv::Vec3d> _translations(_numCameras);
+		std::vector<cv::Vec3d> _frameRotations(mFrames.size());
+		std::vector<cv::Vec3d> _frameTranslations(mFrames.size());
+		for(int _iteration = 0 ; _iteration<_maxIterations ; ++_iteration)
+		{
+			// Reduce the normal equations to the camera poses with the Schur complement of the damped frame blocks.
+			cv::Mat             _S(_numUnknowns, _numUnknowns, CV_64F, cv::Scalar(0));
+			cv::Mat             _g(_numUnknowns, 1, CV_64F, cv::Scalar(0));
+			std::vector<double> _diagonal(_numUnknowns, 0.0);
+			for(size_t f : _rigFrames)
+			{
+				Frame&      _frame = mFrames[f];
+				cv::Matx66d _V     = _frame.V;
+				for(int k = 0 ; k<6 ; ++k)
+				{
+					_V(k, k) *= 1 + _lambda;
+				}
+				_frame.VInverse = _V.inv(cv::DECOMP_CHOLESKY);
+
+				for(int c = 1 ; c<_numCameras ; ++c)
+				{
+					if(_frame.views[c] < 0)
+					{
+						continue;
+					}
+
+					const cv::Matx66d _WVInverse = _frame.W[c] * _frame.VInverse;
+					_S(cv::Rect(6*(c - 1), 6*(c - 1), 6, 6)) += cv::Mat(_frame.U[c]);
+					_g.rowRange(6*(c - 1), 6*c)              += cv::Mat(_frame.gc[c] - _WVInverse * _frame.gf);
+					for(int k = 0 ; k<6 ; ++k)
+					{
+						_diagonal[6*(c - 1) + k] += _frame.U[c](k, k);
+					}
+					for(int d = 1 ; d<_numCameras ; ++d)
+					{
+						if(_frame.views[d] >= 0)
+						{
+							_S(cv::Rect(6*(d - 1), 6*(c - 1), 6, 6)) -= cv::Mat(_WVInverse * _frame.W[d].t());
+						}
+					}
+				}
+			}
+			for(int k = 0 ; k<_numUnknowns ; ++k)
+			{
+				_S.at<double>(k, k) += _lambda * _diagonal[k];
+			}
+
+			cv::Mat _delta;
+			if(!cv::solve(_S, -_g, _delta, cv::DECOMP_CHOLESKY))
+			{
+				break;
+			}
+
+			// Back substitute the chessboard pose of each frame.
+			double _deltaNorm2 = _delta.dot(_delta);
+			double _paramNorm2 = 0;
+			for(int c = 1 ; c<_numCameras ; ++c)
+			{
+				const double* _d = _delta.ptr<double>(6*(c - 1));
+				_rotations[c]    = mRotations[c]    + cv::Vec3d(_d[0], _d[1], _d[2]);
+				_translations[c] = mTranslations[c] + cv::Vec3d(_d[3], _d[4], _d[5]);
+				_paramNorm2     += mRotations[c].dot(mRotations[c]) + mTranslations[c].dot(mTranslations[c]);
+			}
+			for(size_t f : _rigFrames)
+			{
+				const Frame&           _frame = mFrames[f];
+				cv::Matx<double, 6, 1> _rhs   = -_frame.gf;
+				for(int c = 1 ; c<_numCameras ; ++c)
+				{
+					if(_frame.views[c] >= 0)
+					{
+						_rhs -= _frame.W[c].t() * cv::Matx<double, 6, 1>(_delta.ptr<double>(6*(c - 1)));
+					}
+				}
+				const cv::Matx<double, 6, 1> _frameDelta = _frame.VInverse * _rhs;
+				_frameRotations[f]    = _frame.rotation    + cv::Vec3d(_frameDelta(0), _frameDelta(1), _frameDelta(2));
+				_frameTranslations[f] = _frame.translation + cv::Vec3d(_frameDelta(3), _frameDelta(4), _frameDelta(5));
+				_deltaNorm2          += _frameDelta.dot(_frameDelta);
+				_paramNorm2          += _frame.rotation.dot(_frame.rotation) + _frame.translation.dot(_frame.translation);
+			}
+
+			const double _newError = _computeError(_rigFrames, _rotations, _translations, _frameRotations, _frameTranslations);
+			if(_newError < _error)
+			{
+				for(int c = 1 ; c<_numCameras ; ++c)
+				{
+					mRotations[c]    = _rotations[c];
+					mTranslations[c] = _translations[c];
+				}
+				for(size_t f : _rigFrames)
+				{
+					mFrames[f].rotation    = _frameRotations[f];
+					mFrames[f].translation = _frameTranslations[f];
+				}
+				_lambda = std::max(_lambda * 0.1, 1e-12);
+
+				const bool _converged = std::sqrt(_deltaNorm2) <= _epsilon * std::sqrt(_paramNorm2);
+				_error = _buildNormalEquations(_rigFrames);
+				if(_converged)
+				{
+					break;
+				}
+			}
+			else
+			{
+				_lambda *= 10;
+				if(_lambda > 1e12)
+				{
+					break;
+				}
+			}
+		}
+	}
+
+	// The RMS error of each camera over the frames it shares with other cameras.
+	const size_t        _numCorners = mChessBoard3DCornerPositions.size();
+	std::vector<double> _squaredErrors(_numCameras, 0.0);
+	std::vector<int>    _numViews(_numCameras, 0);
+	for(size_t f : _rigFrames)
+	{
+		for(int c = 0 ; c<_numCameras ; ++c)
+		{
+			if(mFrames[f].views[c] >= 0)
+			{
+				_squaredErrors[c] += mFrames[f].squaredErrors[c];
+				_numViews[c]++;
+			}
+		}
+	}
+	for(int c = 0 ; c<_numCameras ; ++c)
+	{
+		mCameraRmsErrors[c] = _numViews[c] > 0 ? std::sqrt(_squaredErrors[c] / (double(_numViews[c]) * _numCorners)) : 0.0;
+	}
+	return _numObservations > 0 ? std::sqrt(_error / (double(_numObservations) * _numCorners)) : 0.0;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Build the blocks of the normal equations of each frame at the current poses. Returns the sum of squared residuals.
+double MultiCameraCalibrator::_buildNormalEquations(const std::vector<size_t>& rigFrames)
+{
+	const int _numCameras = numCameras();
+	const int _numCorners = int(mChessBoard3DCornerPositions.size());
+	cv::parallel_for_(cv::Range(0, int(rigFrames.size())), [&](const cv::Range& range)
+	{
+		std::vector<cv::Point2f> _projected;
+		cv::Mat                  _frameJacobian;
+		cv::Mat                  _cameraJacobian;
+		cv::Mat                  _residuals(2 * _numCorners, 1, CV_64F);
+		for(int i = range.start ; i<range.end ; ++i)
+		{
+			Frame& _frame = mFrames[rigFrames[i]];
+			_frame.V      = cv::Matx66d::zeros();
+			_frame.gf     = cv::Matx<double, 6, 1>::zeros();
+			_frame.U.assign(_numCameras, cv::Matx66d::zeros());
+			_frame.W.assign(_numCameras, cv::Matx66d::zeros());
+			_frame.gc.assign(_numCameras, cv::Matx<double, 6, 1>::zeros());
+			_frame.squaredErrors.assign(_numCameras, 0.0);
+			for(int c = 0 ; c<_numCameras ; ++c)
+			{
+				if(_frame.views[c] < 0)
+				{
+					continue;
+				}
+
+				_projectFrame(c, mRotations[c], mTranslations[c], _frame.rotation, _frame.translation, &_projected, &_frameJacobian, &_cameraJacobian);
+				const std::vector<cv::Point2f>& _corners = mHelpers[c].mAllChessBoardCorners[_frame.views[c]];
+				double*                         _r       = _residuals.ptr<double>();
+				for(int j = 0 ; j<_numCorners ; ++j)
+				{
+					_r[2*j    ] = double(_projected[j].x) - _corners[j].x;
+					_r[2*j + 1] = double(_projected[j].y) - _corners[j].y;
+					_frame.squaredErrors[c] += _r[2*j]*_r[2*j] + _r[2*j + 1]*_r[2*j + 1];
+				}
+
+				_frame.V  += cv::Matx66d(cv::Mat(_frameJacobian.t() * _frameJacobian));
+				_frame.gf += cv::Matx<double, 6, 1>(cv::Mat(_frameJacobian.t() * _residuals));
+				if(c > 0)
+				{
+					_frame.U[c]  = cv::Matx66d(cv::Mat(_cameraJacobian.t() * _cameraJacobian));
+					_frame.W[c]  = cv::Matx66d(cv::Mat(_cameraJacobian.t() * _frameJacobian));
+					_frame.gc[c] = cv::Matx<double, 6, 1>(cv::Mat(_cameraJacobian.t() * _residuals));
+				}
+			}
+		}
+	});
+
+	double _squaredError = 0;
+	for(size_t f : rigFrames)
+	{
+		for(double _e : mFrames[f].squaredErrors)
+		{
+			_squaredError += _e;
+		}
+	}
+	return _squaredError;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+double MultiCameraCalibrator::_computeError(const std::vector<size_t>&    rigFrames,
+	                                        const std::vector<cv::Vec3d>& rotations,
+	                                        const std::vector<cv::Vec3d>& translations,
+	                                        const std::vector<cv::Vec3d>& frameRotations,
+	                                        const std::vector<cv::Vec3d>& frameTranslations) const
+{
+	const int           _numCameras = numCameras();
+	std::vector<double> _squaredErrors(rigFrames.size(), 0.0);
+	cv::parallel_for_(cv::Range(0, int(rigFrames.size())), [&](const cv::Range& range)
+	{
+		std::vector<cv::Point2f> _projected;
+		for(int i = range.start ; i<range.end ; ++i)
+		{
+			const size_t f = rigFrames[i];
+			for(int c = 0 ; c<_numCameras ; ++c)
+			{
+				const int _view = mFrames[f].views[c];
+				if(_view < 0)
+				{
+					continue;
+				}
+
+				// The reference camera stays at the origin.
+				const cv::Vec3d _rotation    = c > 0 ? rotations[c]    : mRotations[0];
+				const cv::Vec3d _translation = c > 0 ? translations[c] : mTranslations[0];
+				_projectFrame(c, _rotation, _translation, frameRotations[f], frameTranslations[f], &_projected, nullptr, nullptr);
+				const std::vector<cv::Point2f>& _corners = mHelpers[c].mAllChessBoardCorners[_view];
+				for(size_t j = 0 ; j<_corners.size() ; ++j)
+				{
+					const cv::Point2f _d = _projected[j] - _corners[j];
+					_squaredErrors[i] += double(_d.x)*_d.x + double(_d.y)*_d.y;
+				}
+			}
+		}
+	});
+
+	double _squaredError = 0;
+	for(double _e : _squaredErrors)
+	{
+		_squaredError += _e;
+	}
+	return _squaredError;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Project the chessboard of a frame into a camera. The chessboard pose in the camera is the chessboard pose in the
+// reference camera followed by the camera pose. If jacobians are given, they are the derivatives of the projected
+// corners by the chessboard pose and by the camera pose, as rotation vector and translation.
+void MultiCameraCalibrator::_projectFrame(int                       camera,
+	                                      const cv::Vec3d&          cameraRotation,
+	                                      const cv::Vec3d&          cameraTranslation,
+	                                      const cv::Vec3d&          frameRotation,
+	                                      const cv::Vec3d&          frameTranslation,
+	                                      std::vector<cv::Point2f>* projected,
+	                                      cv::Mat*                  frameJacobian,
+	                                      cv::Mat*                  cameraJacobian) const
+{
+	const CameraCalibratorHelper& _helper = mHelpers[camera];
+	cv::Vec3d                     _rotation;
+	cv::Vec3d                     _translation;
+	if(!frameJacobian || !cameraJacobian)
+	{
+		cv::composeRT(frameRotation, frameTranslation, cameraRotation, cameraTranslation, _rotation, _translation);
+		cv::projectPoints(mChessBoard3DCornerPositions, _rotation, _translation, _helper.mIntrinsicMatrix, _helper.mDistortionCoeffs, *projected);
+		return;
+	}
+
+	cv::Mat _dr3dr1, _dr3dt1, _dr3dr2, _dr3dt2, _dt3dr1, _dt3dt1, _dt3dr2, _dt3dt2;
+	cv::composeRT(frameRotation, frameTranslation, cameraRotation, cameraTranslation, _rotation, _translation,
+	              _dr3dr1, _dr3dt1, _dr3dr2, _dr3dt2, _dt3dr1, _dt3dt1, _dt3dr2, _dt3dt2);
+
+	cv::Mat _jacobian;
+	cv::projectPoints(mChessBoard3DCornerPositions, _rotation, _translation, _helper.mIntrinsicMatrix, _helper.mDistortionCoeffs, *projected, _jacobian);
+	const cv::Mat _byRotation    = _jacobian.colRange(0, 3);
+	const cv::Mat _byTranslation = _jacobian.colRange(3, 6);
+
+	cv::Mat _rotationByPose;
+	cv::Mat _translationByPose;
+	cv::hconcat(_dr3dr1, _dr3dt1, _rotationByPose);
+	cv::hconcat(_dt3dr1, _dt3dt1, _translationByPose);
+	*frameJacobian = _byRotation * _rotationByPose + _byTranslation * _translationByPose;
+
+	cv::hconcat(_dr3dr2, _dr3dt2, _rotationByPose);
+	cv::hconcat(_dt3dr2, _dt3dt2, _translationByPose);
+	*cameraJacobian = _byRotation * _rotationByPose + _byTranslation * _translationByPose;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// The pose of the second camera relative to the first, x2 = R * x1 + T.
+void MultiCameraCalibrator::_relativePose(int first, int second, cv::Matx33d* rotation, cv::Vec3d* translation) const
+{
+	cv::Matx33d _rotationFirst, _rotationSecond;
+	cv::Vec3d   _translationFirst, _translationSecond;
+	getPose(first , _rotationFirst , _translationFirst);
+	getPose(second, _rotationSecond, _translationSecond);
+
+	*rotation    = _rotationSecond * _rotationFirst.t();
+	*translation = _translationSecond - (*rotation) * _translationFirst;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+}; // end namespace RCamera.
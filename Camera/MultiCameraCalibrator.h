@@ -0,0 +1,91 @@
+
+#ifndef _RVISION_CAMERA_MULTICAMERACALIBRATOR_
+#define _RVISION_CAMERA_MULTICAMERACALIBRATOR_
+
+#include "AbstractCameraCalibrator.h"
+#include "CameraCalibratorHelper.h"
+
+
+namespace RCamera {
+;
+
+// The MultiCameraCalibrator class calibrates a rig of synchronized cameras. The intrinsics of each camera are found
+// from its own views, then the poses of all cameras relative to the reference camera 0 are optimised together with the
+// pose of the chessboard in each frame. A camera doesn't need to see the chessboard in every frame, but every camera
+// must be linked to the reference camera through frames seen by two or more cameras.
+class MultiCameraCalibrator : public AbstractCameraCalibrator
+{
+public:
+
+	explicit MultiCameraCalibrator(int numCameras);
+	MultiCameraCalibrator(int numCameras, const CalibratorConfiguration& configuration);
+	~MultiCameraCalibrator();
+
+
+	// Set next frame for calibration, one image per camera. The chessboard is searched in all images in parallel and
+	// the frame is accepted if at least one camera sees it. Passing no images forces camera calibration.
+	CameraCalibrationStatus setImage(const std::vector<const unsigned char*>& images, int width, int height, int bytesPerPixel, int numRowbytes);
+
+
+	void saveParametersToJSON(nlohmann::json* json) const override;
+	void setConfiguration(const CalibratorConfiguration& configuration) override;
+	void getParameters(int camera, std::vector<double>& intrinsic, std::vector<double>& distortion) const;
+	void getDebugParameters(int camera, double& coverage, double& rmsError) const;
+	void getPose(int camera, cv::Matx33d& rotation, cv::Vec3d& translation) const;
+
+	inline int    numCameras()  const {return int(mHelpers.size());}
+	inline double rigRmsError() const {return mRigRmsError;}
+
+	// The number of accepted views covering each cell of the coverage grid of a camera, empty if CoverageGridWidth is 0.
+	inline const cv::Mat& coverageGrid(int camera) const {return mHelpers[camera].mCoverageGrid;}
+
+
+	#if defined(RVISIONLIB_HAVE_QT)
+		inline QImage displayImage(int camera) const {return mHelpers[camera].displayImage();}
+	#endif
+
+
+private:
+
+	// The Frame struct holds the views of one accepted frame, the pose of the chessboard in the reference camera and the
+	// blocks of the normal equations of the rig optimisation.
+	struct Frame
+	{
+		std::vector<int>                    views;         // The index of the view in the helper of each camera, -1 if the camera didn't see the chessboard.
+		cv::Vec3d                           rotation;      // The pose of the chessboard in the reference camera.
+		cv::Vec3d                           translation;
+		cv::Matx66d                         V;             // Jf^T * Jf, chessboard pose block.
+		cv::Matx<double, 6, 1>              gf;            // Jf^T * residuals.
+		cv::Matx66d                         VInverse;      // Inverse of the damped chessboard pose block.
+		std::vector<cv::Matx66d>            U;             // Jc^T * Jc of each camera.
+		std::vector<cv::Matx66d>            W;             // Jc^T * Jf of each camera.
+		std::vector<cv::Matx<double, 6, 1>> gc;            // Jc^T * residuals of each camera.
+		std::vector<double>                 squaredErrors; // The sum of squared residuals of each camera.
+	};
+
+	bool   _calibrateCamera();
+	bool   _initializePoses(const std::vector<std::vector<cv::Mat>>& rotationVectors, const std::vector<std::vector<cv::Mat>>& translationVectors,
+	                        const std::vector<std::vector<double>>& perViewErrors);
+	double _optimizePoses();
+	double _buildNormalEquations(const std::vector<size_t>& rigFrames);
+	double _computeError(const std::vector<size_t>& rigFrames, const std::vector<cv::Vec3d>& rotations, const std::vector<cv::Vec3d>& translations,
+	                     const std::vector<cv::Vec3d>& frameRotations, const std::vector<cv::Vec3d>& frameTranslations) const;
+	void   _projectFrame(int camera, const cv::Vec3d& cameraRotation, const cv::Vec3d& cameraTranslation, const cv::Vec3d& frameRotation,
+	                     const cv::Vec3d& frameTranslation, std::vector<cv::Point2f>* projected, cv::Mat* frameJacobian, cv::Mat* cameraJacobian) const;
+	void   _relativePose(int first, int second, cv::Matx33d* rotation, cv::Vec3d* translation) const;
+
+
+private:
+
+	std::vector<CameraCalibratorHelper> mHelpers;                     // One helper per camera, camera 0 is the reference.
+	std::vector<Frame>                  mFrames;                      // The accepted frames.
+	std::vector<cv::Point3f>            mChessBoard3DCornerPositions;
+	std::vector<cv::Vec3d>              mRotations;                   // The rotation of each camera relative to the reference camera, x = R * x0 + t.
+	std::vector<cv::Vec3d>              mTranslations;                // The translation of each camera relative to the reference camera.
+	std::vector<double>                 mCameraRmsErrors;             // The RMS error of each camera after the rig optimisation.
+	double                              mRigRmsError;                 // The RMS error of the rig optimisation over all cameras.
+};
+
+}; // end namespace RCamera
+
+#endif // _RVISION_CAMERA_MULTICAMERACALIBRATOR_
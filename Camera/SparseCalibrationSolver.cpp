@@ -0,0 +1,436 @@
+
+#include "SparseCalibrationSolver.h"
+
+#include "opencv2/calib3d.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+
+namespace RCamera {
+;
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+SparseCalibrationSolver::SparseCalibrationSolver(int calibrationFlag, const cv::TermCriteria& criteria)
+	: mCalibrationFlag(calibrationFlag),
+	  mCriteria(criteria),
+	  mAspectRatio(0),
+	  mNumIterations(0),
+	  mObjectPoints(nullptr),
+	  mImagePoints(nullptr),
+	  mIsCancelled(nullptr)
+{
+	std::fill(std::begin(mIsFixed), std::end(mIsFixed), false);
+	if(mCalibrationFlag & cv::CALIB_FIX_FOCAL_LENGTH)    {mIsFixed[0] = mIsFixed[1] = true;}
+	if(mCalibrationFlag & cv::CALIB_FIX_ASPECT_RATIO)    {mIsFixed[1] = true;} // fy follows fx.
+	if(mCalibrationFlag & cv::CALIB_FIX_PRINCIPAL_POINT) {mIsFixed[2] = mIsFixed[3] = true;}
+	if(mCalibrationFlag & cv::CALIB_FIX_K1)              {mIsFixed[4] = true;}
+	if(mCalibrationFlag & cv::CALIB_FIX_K2)              {mIsFixed[5] = true;}
+	if(mCalibrationFlag & cv::CALIB_ZERO_TANGENT_DIST)   {mIsFixed[6] = mIsFixed[7] = true;}
+	if(mCalibrationFlag & cv::CALIB_FIX_K3)              {mIsFixed[8] = true;}
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+double SparseCalibrationSolver::calibrate(const std::vector<std::vector<cv::Point3f>>& objectPoints,
+	                                      const std::vector<std::vector<cv::Point2f>>& imagePoints,
+	                                      const cv::Size&                              imageSize,
+	                                      cv::Mat&                                     intrinsicMatrix,
+	                                      cv::Mat&                                     distortionCoeffs,
+	                                      std::vector<cv::Mat>&                        rotationVectors,
+	                                      std::vector<cv::Mat>&                        translationVectors)
+{
+	CV_Assert(!objectPoints.empty() && objectPoints.size() == imagePoints.size());
+
+	mObjectPoints  = &objectPoints;
+	mImagePoints   = &imagePoints;
+	mImageSize     = imageSize;
+	mAspectRatio   = 0;
+	mNumIterations = 0;
+	mViews.assign(objectPoints.size(), View());
+
+	size_t _numPoints = 0;
+	for(const auto& _points : imagePoints)
+	{
+		_numPoints += _points.size();
+	}
+
+	Intrinsics _intrinsics = _initialIntrinsics(intrinsicMatrix, distortionCoeffs);
+	_initialExtrinsics(_intrinsics);
+
+	const int    _maxIterations = (mCriteria.type & cv::TermCriteria::COUNT) ? mCriteria.maxCount : 30;
+	const double _epsilon       = (mCriteria.type & cv::TermCriteria::EPS)   ? mCriteria.epsilon  : DBL_EPSILON;
+	const size_t _numViews      = mViews.size();
+
+	double _error  = _buildNormalEquations(_intrinsics);
+	double _lambda = 1e-3;
+
+	std::vector<cv::Vec3d> _rotations(_numViews);
+	std::vector<cv::Vec3d> _translations(_numViews);
+	while(mNumIterations < _maxIterations && !(mIsCancelled && *mIsCancelled))
+	{
+		mNumIterations++;
+
+		// Reduce the normal equations to the intrinsics with the Schur complement of the damped extrinsics blocks.
+		cv::parallel_for_(cv::Range(0, int(_numViews)), [&](const cv::Range& range)
+		{
+			for(int i = range.start ; i<range.end ; ++i)
+			{
+				View&       _view = mViews[i];
+				cv::Matx66d _V    = _view.V;
+				for(int k = 0 ; k<6 ; ++k)
+				{
+					_V(k, k) *= 1 + _lambda;
+				}
+				_view.VInverse = _V.inv(cv::DECOMP_CHOLESKY);
+				const cv::Matx<double, 9, 6> _WVInverse = _view.W * _view.VInverse;
+				_view.schurU = _WVInverse * _view.W.t();
+				_view.schurG = _WVInverse * _view.gp;
+			}
+		});
+
+		cv::Matx<double, 9, 9> _S;
+		cv::Matx<double, 9, 1> _g;
+		for(const View& _view : mViews)
+		{
+			_S += _view.U - _view.schurU;
+			_g += _view.gc - _view.schurG;
+		}
+		for(int k = 0 ; k<9 ; ++k)
+		{
+			if(mIsFixed[k])
+			{
+				for(int l = 0 ; l<9 ; ++l)
+				{
+					_S(k, l) = _S(l, k) = 0;
+				}
+				_S(k, k) = 1;
+				_g(k)    = 0;
+			}
+			else
+			{
+				// Damp with the undamped diagonal, the Schur terms don't belong to it.
+				double _diagonal = 0;
+				for(const View& _view : mViews)
+				{
+					_diagonal += _view.U(k, k);
+				}
+				_S(k, k) += _lambda * _diagonal;
+			}
+		}
+
+		const cv::Matx<double, 9, 1> _deltaIntrinsics = _S.solve(-_g, cv::DECOMP_CHOLESKY);
+
+		// Back substitute the extrinsics of each view.
+		Intrinsics _newIntrinsics = _intrinsics + _deltaIntrinsics;
+		_applyAspectRatio(&_newIntrinsics);
+		double _deltaNorm2 = _deltaIntrinsics.dot(_deltaIntrinsics);
+		double _paramNorm2 = _intrinsics.dot(_intrinsics);
+		for(size_t i = 0 ; i<_numViews ; ++i)
+		{
+			const View&                  _view  = mViews[i];
+			const cv::Matx<double, 6, 1> _delta = _view.VInverse * (-_view.gp - _view.W.t() * _deltaIntrinsics);
+			_rotations[i]    = _view.rotation    + cv::Vec3d(_delta(0), _delta(1), _delta(2));
+			_translations[i] = _view.translation + cv::Vec3d(_delta(3), _delta(4), _delta(5));
+			_deltaNorm2     += _delta.dot(_delta);
+			_paramNorm2     += _view.rotation.dot(_view.rotation) + _view.translation.dot(_view.translation);
+		}
+
+		const double _newError = _computeError(_newIntrinsics, _rotations, _translations);
+		if(_newError < _error)
+		{
+			_intrinsics = _newIntrinsics;
+			for(size_t i = 0 ; i<_numViews ; ++i)
+			{
+				mViews[i].rotation    = _rotations[i];
+				mViews[i].translation = _translations[i];
+			}
+			_lambda = std::max(_lambda * 0.1, 1e-12);
+
+			const bool _converged = std::sqrt(_deltaNorm2) <= _epsilon * std::sqrt(_paramNorm2);
+			_error = _buildNormalEquations(_intrinsics);
+			if(_converged)
+			{
+				break;
+			}
+		}
+		else
+		{
+			_lambda *= 10;
+			if(_lambda > 1e12)
+			{
+				break;
+			}
+		}
+	}
+
+	intrinsicMatrix  = cv::Mat(_cameraMatrix(_intrinsics), true);
+	distortionCoeffs = cv::Mat(_distortionCoeffs(_intrinsics), true);
+	rotationVectors.resize(_numViews);
+	translationVectors.resize(_numViews);
+	for(size_t i = 0 ; i<_numViews ; ++i)
+	{
+		rotationVectors[i]    = cv::Mat(mViews[i].rotation, true);
+		translationVectors[i] = cv::Mat(mViews[i].translation, true);
+	}
+
+	return std::sqrt(_error / std::max<size_t>(_numPoints, 1));
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// The RMS re-projection error of each view of the last call to calibrate(). The squared errors are accumulated in 
+// parallel with the Jacobians, so this doesn't project the points again.
+std::vector<double> SparseCalibrationSolver::perViewErrors() const
+{
+	std::vector<double> _errors(mViews.size(), 0.0);
+	for(size_t i = 0 ; i<mViews.size() ; ++i)
+	{
+		const size_t _numPoints = (*mImagePoints)[i].size();
+		_errors[i] = _numPoints > 0 ? std::sqrt(mViews[i].squaredError / _numPoints) : 0.0;
+	}
+	return _errors;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Without an intrinsic guess, the principal point is the image centre and the focal lengths are estimated from the 
+// homographies of the views, in the same way as cv::calibrateCamera.
+SparseCalibrationSolver::Intrinsics SparseCalibrationSolver::_initialIntrinsics(const cv::Mat& intrinsicMatrix, const cv::Mat& distortionCoeffs)
+{
+	Intrinsics _intrinsics;
+
+	cv::Matx33d _guess = cv::Matx33d::eye();
+	if(intrinsicMatrix.rows == 3 && intrinsicMatrix.cols == 3)
+	{
+		cv::Mat _matrix;
+		intrinsicMatrix.convertTo(_matrix, CV_64F);
+		_guess = cv::Matx33d(_matrix);
+	}
+
+	if(mCalibrationFlag & cv::CALIB_FIX_ASPECT_RATIO)
+	{
+		mAspectRatio = _guess(0, 0) / _guess(1, 1);
+	}
+
+	if(mCalibrationFlag & cv::CALIB_USE_INTRINSIC_GUESS)
+	{
+		_intrinsics(0) = _guess(0, 0);
+		_intrinsics(1) = _guess(1, 1);
+		_intrinsics(2) = _guess(0, 2);
+		_intrinsics(3) = _guess(1, 2);
+
+		cv::Mat _distortion;
+		distortionCoeffs.convertTo(_distortion, CV_64F);
+		for(int k = 0 ; k<std::min(int(_distortion.total()), 5) ; ++k)
+		{
+			_intrinsics(4 + k) = _distortion.at<double>(k);
+		}
+	}
+	else
+	{
+		_intrinsics(2) = (mImageSize.width  - 1) * 0.5;
+		_intrinsics(3) = (mImageSize.height - 1) * 0.5;
+
+		// Each homography gives two constraints on 1/fx^2 and 1/fy^2 from the orthogonality and equal length of the 
+		// first two rotation columns.
+		const size_t _numViews = mObjectPoints->size();
+		cv::Mat      _A(int(2 * _numViews), 2, CV_64F);
+		cv::Mat      _b(int(2 * _numViews), 1, CV_64F);
+		for(size_t i = 0 ; i<_numViews ; ++i)
+		{
+			std::vector<cv::Point2f> _planePoints;
+			for(const cv::Point3f& p : (*mObjectPoints)[i])
+			{
+				_planePoints.emplace_back(p.x, p.y);
+			}
+			cv::Matx33d _H = cv::Matx33d::eye();
+			cv::Mat     _homography = cv::findHomography(_planePoints, (*mImagePoints)[i]);
+			if(!_homography.empty())
+			{
+				_H = cv::Matx33d(_homography);
+			}
+			_H = cv::Matx33d(1, 0, -_intrinsics(2), 0, 1, -_intrinsics(3), 0, 0, 1) * _H;
+
+			cv::Vec3d _n[4];
+			_n[0] = cv::Vec3d(_H(0, 0), _H(1, 0), _H(2, 0));
+			_n[1] = cv::Vec3d(_H(0, 1), _H(1, 1), _H(2, 1));
+			_n[2] = _n[0] + _n[1];
+			_n[3] = _n[0] - _n[1];
+			for(cv::Vec3d& n : _n)
+			{
+				n *= 1.0 / std::max(cv::norm(n), DBL_EPSILON);
+			}
+
+			for(int j = 0 ; j<2 ; ++j)
+			{
+				const cv::Vec3d& _u = _n[2*j];
+				const cv::Vec3d& _v = _n[2*j + 1];
+				_A.at<double>(int(2*i + j), 0) = _u[0] * _v[0];
+				_A.at<double>(int(2*i + j), 1) = _u[1] * _v[1];
+				_b.at<double>(int(2*i + j), 0) = -_u[2] * _v[2];
+			}
+		}
+
+		cv::Mat _f;
+		cv::solve(_A, _b, _f, cv::DECOMP_SVD);
+		const double _fallback = std::max(mImageSize.width, mImageSize.height);
+		_intrinsics(0) = _f.at<double>(0) != 0 ? std::sqrt(std::abs(1.0 / _f.at<double>(0))) : _fallback;
+		_intrinsics(1) = _f.at<double>(1) != 0 ? std::sqrt(std::abs(1.0 / _f.at<double>(1))) : _fallback;
+
+		if(mAspectRatio > 0)
+		{
+			const double _fy = (_intrinsics(0) + _intrinsics(1)) / (mAspectRatio + 1);
+			_intrinsics(0) = mAspectRatio * _fy;
+			_intrinsics(1) = _fy;
+		}
+	}
+
+	if(mCalibrationFlag & cv::CALIB_ZERO_TANGENT_DIST)
+	{
+		_intrinsics(6) = _intrinsics(7) = 0;
+	}
+	return _intrinsics;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+void SparseCalibrationSolver::_initialExtrinsics(const Intrinsics& intrinsics)
+{
+	const cv::Matx33d        _cameraMatrix     = SparseCalibrationSolver::_cameraMatrix(intrinsics);
+	const cv::Vec<double, 5> _distortionCoeffs = SparseCalibrationSolver::_distortionCoeffs(intrinsics);
+	cv::parallel_for_(cv::Range(0, int(mViews.size())), [&](const cv::Range& range)
+	{
+		for(int i = range.start ; i<range.end ; ++i)
+		{
+			cv::solvePnP((*mObjectPoints)[i], (*mImagePoints)[i], _cameraMatrix, _distortionCoeffs, mViews[i].rotation, mViews[i].translation);
+		}
+	});
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Compute the Jacobian of each view in parallel and accumulate its blocks of the normal equations. Returns the sum of 
+// squared residuals.
+double SparseCalibrationSolver::_buildNormalEquations(const Intrinsics& intrinsics)
+{
+	const cv::Matx33d        _cameraMatrix     = SparseCalibrationSolver::_cameraMatrix(intrinsics);
+	const cv::Vec<double, 5> _distortionCoeffs = SparseCalibrationSolver::_distortionCoeffs(intrinsics);
+	cv::parallel_for_(cv::Range(0, int(mViews.size())), [&](const cv::Range& range)
+	{
+		for(int i = range.start ; i<range.end ; ++i)
+		{
+			View&                           _view        = mViews[i];
+			const std::vector<cv::Point2f>& _imagePoints = (*mImagePoints)[i];
+			cv::projectPoints((*mObjectPoints)[i], _view.rotation, _view.translation, _cameraMatrix, _distortionCoeffs, 
+			                  _view.projected, _view.jacobian);
+
+			_view.V  = cv::Matx66d();
+			_view.W  = cv::Matx<double, 9, 6>();
+			_view.U  = cv::Matx<double, 9, 9>();
+			_view.gp = cv::Matx<double, 6, 1>();
+			_view.gc = cv::Matx<double, 9, 1>();
+			_view.squaredError = 0;
+
+			// The Jacobian columns are rotation, translation, fx, fy, cx, cy and the distortion coefficients.
+			for(int j = 0 ; j<int(_imagePoints.size()) ; ++j)
+			{
+				const double _residuals[2] = {double(_view.projected[j].x) - _imagePoints[j].x, double(_view.projected[j].y) - _imagePoints[j].y};
+				for(int r = 0 ; r<2 ; ++r)
+				{
+					const double*          _row = _view.jacobian.ptr<double>(2*j + r);
+					cv::Matx<double, 6, 1> _Jp(_row);
+					cv::Matx<double, 9, 1> _Jc(_row + 6);
+					if(mAspectRatio > 0)
+					{
+						_Jc(0) += _Jc(1) / mAspectRatio;
+					}
+					for(int k = 0 ; k<9 ; ++k)
+					{
+						if(mIsFixed[k]) {_Jc(k) = 0;}
+					}
+
+					_view.V  += _Jp * _Jp.t();
+					_view.W  += _Jc * _Jp.t();
+					_view.U  += _Jc * _Jc.t();
+					_view.gp += _Jp * _residuals[r];
+					_view.gc += _Jc * _residuals[r];
+					_view.squaredError += _residuals[r] * _residuals[r];
+				}
+			}
+		}
+	});
+
+	double _error = 0;
+	for(const View& _view : mViews)
+	{
+		_error += _view.squaredError;
+	}
+	return _error;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+double SparseCalibrationSolver::_computeError(const Intrinsics&             intrinsics, 
+	                                          const std::vector<cv::Vec3d>& rotations, 
+	                                          const std::vector<cv::Vec3d>& translations)
+{
+	const cv::Matx33d        _cameraMatrix     = SparseCalibrationSolver::_cameraMatrix(intrinsics);
+	const cv::Vec<double, 5> _distortionCoeffs = SparseCalibrationSolver::_distortionCoeffs(intrinsics);
+	std::vector<double>      _errors(mViews.size(), 0.0);
+	cv::parallel_for_(cv::Range(0, int(mViews.size())), [&](const cv::Range& range)
+	{
+		std::vector<cv::Point2f> _projected;
+		for(int i = range.start ; i<range.end ; ++i)
+		{
+			const std::vector<cv::Point2f>& _imagePoints = (*mImagePoints)[i];
+			cv::projectPoints((*mObjectPoints)[i], rotations[i], translations[i], _cameraMatrix, _distortionCoeffs, _projected);
+			for(size_t j = 0 ; j<_imagePoints.size() ; ++j)
+			{
+				const cv::Point2d _residual = cv::Point2d(_projected[j]) - cv::Point2d(_imagePoints[j]);
+				_errors[i] += _residual.dot(_residual);
+			}
+		}
+	});
+
+	double _error = 0;
+	for(double e : _errors)
+	{
+		_error += e;
+	}
+	return _error;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+void SparseCalibrationSolver::_applyAspectRatio(Intrinsics* intrinsics) const
+{
+	if(mAspectRatio > 0)
+	{
+		(*intrinsics)(1) = (*intrinsics)(0) / mAspectRatio;
+	}
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+cv::Matx33d SparseCalibrationSolver::_cameraMatrix(const Intrinsics& intrinsics)
+{
+	return cv::Matx33d(intrinsics(0), 0, intrinsics(2), 0, intrinsics(1), intrinsics(3), 0, 0, 1);
+}
+cv::Vec<double, 5> SparseCalibrationSolver::_distortionCoeffs(const Intrinsics& intrinsics)
+{
+	return cv::Vec<double, 5>(intrinsics(4), intrinsics(5), intrinsics(6), intrinsics(7), intrinsics(8));
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+}; // end namespace RCamera
@@ -0,0 +1,87 @@
+
+#ifndef _RVISION_CAMERA_SPARSECALIBRATIONSOLVER_H_
+#define _RVISION_CAMERA_SPARSECALIBRATIONSOLVER_H_
+
+#include "opencv2/core.hpp"
+
+#include <atomic>
+#include <vector>
+
+
+namespace RCamera {
+;
+
+// The SparseCalibrationSolver class calibrates a camera from views of a planar chessboard, with the same inputs and 
+// outputs as cv::calibrateCamera. The normal equations of the Levenberg-Marquardt solver have one 6x6 block per view 
+// for the extrinsics and one block for the shared intrinsics. The extrinsics are eliminated with the Schur complement, 
+// so each iteration only solves a 9x9 system and the cost grows linearly with the number of views.
+// The distortion model is k1, k2, p1, p2, k3. The supported calibration flags are CALIB_USE_INTRINSIC_GUESS, 
+// CALIB_FIX_FOCAL_LENGTH, CALIB_FIX_PRINCIPAL_POINT, CALIB_FIX_ASPECT_RATIO, CALIB_ZERO_TANGENT_DIST and CALIB_FIX_K1-K3.
+class SparseCalibrationSolver
+{
+public:
+
+	SparseCalibrationSolver(int calibrationFlag, const cv::TermCriteria& criteria);
+
+	double calibrate(const std::vector<std::vector<cv::Point3f>>& objectPoints,
+	                 const std::vector<std::vector<cv::Point2f>>& imagePoints,
+	                 const cv::Size&                              imageSize,
+	                 cv::Mat&                                     intrinsicMatrix,
+	                 cv::Mat&                                     distortionCoeffs,
+	                 std::vector<cv::Mat>&                        rotationVectors,
+	                 std::vector<cv::Mat>&                        translationVectors);
+
+	inline void         setCancelFlag(const std::atomic<bool>* isCancelled) {mIsCancelled = isCancelled;}
+	inline int          numIterations() const {return mNumIterations;}
+	std::vector<double> perViewErrors() const;
+
+
+private:
+
+	typedef cv::Matx<double, 9, 1> Intrinsics; // fx, fy, cx, cy, k1, k2, p1, p2, k3.
+
+	// The View struct holds the extrinsics of one view and its blocks of the normal equations.
+	struct View
+	{
+		cv::Vec3d                rotation;
+		cv::Vec3d                translation;
+		cv::Matx66d              V;             // Jp^T * Jp, extrinsics block.
+		cv::Matx<double, 9, 6>   W;             // Jc^T * Jp, coupling between intrinsics and extrinsics.
+		cv::Matx<double, 9, 9>   U;             // Jc^T * Jc, contribution to the intrinsics block.
+		cv::Matx<double, 6, 1>   gp;            // Jp^T * residuals.
+		cv::Matx<double, 9, 1>   gc;            // Jc^T * residuals.
+		cv::Matx66d              VInverse;      // Inverse of the damped extrinsics block.
+		cv::Matx<double, 9, 9>   schurU;        // W * VInverse * W^T.
+		cv::Matx<double, 9, 1>   schurG;        // W * VInverse * gp.
+		double                   squaredError;  // Sum of squared residuals.
+		std::vector<cv::Point2f> projected;     // Buffers reused by projectPoints() between iterations.
+		cv::Mat                  jacobian;
+	};
+
+	Intrinsics  _initialIntrinsics(const cv::Mat& intrinsicMatrix, const cv::Mat& distortionCoeffs);
+	void        _initialExtrinsics(const Intrinsics& intrinsics);
+	double      _buildNormalEquations(const Intrinsics& intrinsics);
+	double      _computeError(const Intrinsics& intrinsics, const std::vector<cv::Vec3d>& rotations, const std::vector<cv::Vec3d>& translations);
+	void        _applyAspectRatio(Intrinsics* intrinsics) const;
+
+	static cv::Matx33d _cameraMatrix(const Intrinsics& intrinsics);
+	static cv::Vec<double, 5> _distortionCoeffs(const Intrinsics& intrinsics);
+
+
+private:
+
+	int                                          mCalibrationFlag; // OpenCV calibration flags.
+	cv::TermCriteria                             mCriteria;        // The maximum number of iterations and the minimum relative parameter change.
+	bool                                         mIsFixed[9];      // True for intrinsics which are not optimised.
+	double                                       mAspectRatio;     // fx / fy if CALIB_FIX_ASPECT_RATIO is set, otherwise 0.
+	int                                          mNumIterations;   // The number of iterations of the last call to calibrate().
+	cv::Size                                     mImageSize;       // The size of the input images.
+	const std::vector<std::vector<cv::Point3f>>* mObjectPoints;    // The inputs of the current call to calibrate().
+	const std::vector<std::vector<cv::Point2f>>* mImagePoints;
+	std::vector<View>                            mViews;
+	const std::atomic<bool>*                     mIsCancelled;     // If set, calibrate() returns after the current iteration once the flag is true.
+};
+
+}; // end namespace RCamera
+
+#endif // _RVISION_CAMERA_SPARSECALIBRATIONSOLVER_H_
@@ -6,6 +6,8 @@
 #include "opencv2/highgui.hpp"
 
 #include <iostream>
+#include <chrono>
+#include <future>
 
 
 namespace RCamera {
@@ -102,12 +104,10 @@ CameraCalibrationStatus StereoCameraCalibrator::setImage(const unsigned char* le
 			}
 
 			mLeftHelper.updateCorners (_leftImage , _leftCorners);
-			mLeftHelper.updateDisplayImage(_leftImage);
-			mLeftHelper.drawChessboardCorners(_leftCorners);
+			mLeftHelper.setDisplayImage(mLeftHelper.mAcceptedImages.back(), _leftCorners);
 
 			mRightHelper.updateCorners(_rightImage, _rightCorners);
-			mRightHelper.updateDisplayImage(_rightImage);
-			mRightHelper.drawChessboardCorners(_rightCorners);
+			mRightHelper.setDisplayImage(mRightHelper.mAcceptedImages.back(), _rightCorners);
 
 			if(mConfiguration.drawChessboardCorners() && !mConfiguration.saveOnlyLastChessboardImage())
 			{
@@ -145,8 +145,9 @@ CameraCalibrationStatus StereoCameraCalibrator::setImage(const unsigned char* le
 		}
 		else
 		{
-			mLeftHelper.updateDisplayImage(_leftImage);
-			mRightHelper.updateDisplayImage(_rightImage);
+			// The images may still reference the caller's buffers, which can be reused before the display image is rendered.
+			mLeftHelper.setDisplayImage (_leftImage.data  == leftImage  ? _leftImage.clone()  : _leftImage);
+			mRightHelper.setDisplayImage(_rightImage.data == rightImage ? _rightImage.clone() : _rightImage);
 			return CameraCalibrationStatus::ImageRejected;
 		}
 	}
@@ -278,13 +279,37 @@ void StereoCameraCalibrator::getDebugParameters(double& leftCoverage, double& le
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 bool StereoCameraCalibrator::_calibrateCamera()
 {
-	mLeftHelper.initializeCameraParameters();
-	mRightHelper.initializeCameraParameters();
 	int _calibrationFlag = mConfiguration.calibrationFlag();
 	
 	std::vector<cv::Point3f>              _chessBoard3DCornerPositions = mLeftHelper.calculateChessboard3DCornerPositions();
 	std::vector<std::vector<cv::Point3f>> _allChessBoard3DCornerPositions(mNumImagesAccepted, _chessBoard3DCornerPositions);
 
+	// In two phases, the intrinsics of both cameras are found first, each on its own thread. stereoCalibrate() then 
+	// only has to solve the relative pose, or refine the intrinsics from a good starting point, instead of solving 
+	// everything from identity intrinsics.
+	auto _startTime = std::chrono::high_resolution_clock::now();
+	if(mConfiguration.stereoTwoPhase())
+	{
+		// A cv::Exception thrown on the left thread is passed on by get(), and the future waits for the thread if the right 
+		// camera throws first.
+		std::future<double> _leftFuture    = std::async(std::launch::async, [&]() {return _calibrateIntrinsics(&mLeftHelper, _allChessBoard3DCornerPositions, _calibrationFlag);});
+		const double        _rightRmsError = _calibrateIntrinsics(&mRightHelper, _allChessBoard3DCornerPositions, _calibrationFlag);
+		const double        _leftRmsError  = _leftFuture.get();
+
+		std::cout << fmt::format("Left Intrinsic Re-projection Error={:.5f}, Right Intrinsic Re-projection Error={:.5f}\n", _leftRmsError, _rightRmsError);
+		if(!mLeftHelper.mCameraParamersValid || !mRightHelper.mCameraParamersValid)
+		{
+			return false;
+		}
+		_calibrationFlag |= mConfiguration.stereoRefineIntrinsics() ? cv::CALIB_USE_INTRINSIC_GUESS : cv::CALIB_FIX_INTRINSIC;
+	}
+	else
+	{
+		mLeftHelper.initializeCameraParameters();
+		mRightHelper.initializeCameraParameters();
+	}
+	auto _intrinsicsTime = std::chrono::high_resolution_clock::now();
+
 	// Find intrinsic and extrinsic camera parameters	
 	cv::Mat _rotationMatrix;
 	cv::Mat _translationMatrix;
@@ -300,6 +325,18 @@ bool StereoCameraCalibrator::_calibrateCamera()
 										  _rotationMatrix, _translationMatrix, 
 		                                  _essentialMatrix, _fundamentalMatrix,
 		                                  _calibrationFlag);
+	auto _endTime = std::chrono::high_resolution_clock::now();
+
+	if(mConfiguration.stereoTwoPhase())
+	{
+		std::cout << fmt::format("Time taken for calibration: intrinsics {:.0f} ms, stereo {:.0f} ms\n", 
+		                         std::chrono::duration<double, std::milli>(_intrinsicsTime - _startTime).count(),
+		                         std::chrono::duration<double, std::milli>(_endTime - _intrinsicsTime).count());
+	}
+	else
+	{
+		std::cout << fmt::format("Time taken for calibration: {:.0f} ms\n", std::chrono::duration<double, std::milli>(_endTime - _startTime).count());
+	}
 	
 	mLeftHelper.mLastRmsError  = rmsError;
 	mRightHelper.mLastRmsError = rmsError;
@@ -310,6 +347,7 @@ bool StereoCameraCalibrator::_calibrateCamera()
 
 	std::cout << fmt::format("Re-projection Error={:.5f}, Left Coverage={:.3f}, Right Coverage={:.3f}\n", rmsError, mLeftHelper.mCoveragePercentage, mRightHelper.mCoveragePercentage);
 	std::cout << fmt::format("Calibration Flag is ={:1d}\n", _calibrationFlag);
+	_calculateReprojectionErrors(_allChessBoard3DCornerPositions);
 	std::cout << "Left Camera Matrix    : "<< mLeftHelper.mIntrinsicMatrix << "\n";
 	std::cout << "Left Distortion Coeff : "<< mLeftHelper.mDistortionCoeffs << "\n";
 	std::cout << "Right Camera Matrix   : "<< mRightHelper.mIntrinsicMatrix << "\n";
@@ -322,4 +360,69 @@ bool StereoCameraCalibrator::_calibrateCamera()
 }
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// Calibrate one camera of the pair from its own views. Returns the RMS error.
+double StereoCameraCalibrator::_calibrateIntrinsics(CameraCalibratorHelper*                      helper, 
+	                                                const std::vector<std::vector<cv::Point3f>>& allChessBoard3DCornerPositions, 
+	                                                int                                          calibrationFlag) const
+{
+	helper->initializeCameraParameters();
+
+	std::vector<cv::Mat> _rotationVectors;
+	std::vector<cv::Mat> _translationVectors;
+	const double _rmsError = cv::calibrateCamera(allChessBoard3DCornerPositions, helper->mAllChessBoardCorners, helper->mInputImageSize,
+	                                             helper->mIntrinsicMatrix, helper->mDistortionCoeffs, _rotationVectors, _translationVectors, 
+	                                             calibrationFlag);
+
+	helper->mCameraParamersValid = cv::checkRange(helper->mIntrinsicMatrix) && cv::checkRange(helper->mDistortionCoeffs);
+	return _rmsError;
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+// stereoCalibrate() doesn't return the pose of each view, so the left camera poses are found with solvePnP() and the 
+// right camera poses follow from the stereo rotation and translation.
+void StereoCameraCalibrator::_calculateReprojectionErrors(const std::vector<std::vector<cv::Point3f>>& allChessBoard3DCornerPositions)
+{
+	if(!cv::checkRange(mLeftHelper.mIntrinsicMatrix) || !cv::checkRange(mLeftHelper.mDistortionCoeffs) || mRotationMatrix.empty())
+	{
+		return;
+	}
+
+	const size_t         _numImages = allChessBoard3DCornerPositions.size();
+	std::vector<cv::Mat> _leftRotationVectors(_numImages);
+	std::vector<cv::Mat> _leftTranslationVectors(_numImages);
+	std::vector<cv::Mat> _rightRotationVectors(_numImages);
+	std::vector<cv::Mat> _rightTranslationVectors(_numImages);
+	const cv::Matx33d    _R(mRotationMatrix);
+	const cv::Vec3d      _T(mTranslationMatrix.ptr<double>());
+	cv::parallel_for_(cv::Range(0, int(_numImages)), [&](const cv::Range& range)
+	{
+		for(int i = range.start ; i<range.end ; ++i)
+		{
+			cv::Vec3d _rotation, _translation;
+			cv::solvePnP(allChessBoard3DCornerPositions[i], mLeftHelper.mAllChessBoardCorners[i], 
+			             mLeftHelper.mIntrinsicMatrix, mLeftHelper.mDistortionCoeffs, _rotation, _translation);
+
+			cv::Matx33d _leftRotation;
+			cv::Rodrigues(_rotation, _leftRotation);
+			cv::Vec3d _rightRotation;
+			cv::Rodrigues(_R * _leftRotation, _rightRotation);
+
+			_leftRotationVectors[i]     = cv::Mat(_rotation, true);
+			_leftTranslationVectors[i]  = cv::Mat(_translation, true);
+			_rightRotationVectors[i]    = cv::Mat(_rightRotation, true);
+			_rightTranslationVectors[i] = cv::Mat(cv::Vec3d(_R * _translation + _T), true);
+		}
+	});
+
+	const ReprojectionErrors& _leftErrors  = mLeftHelper.calculateReprojectionErrors(allChessBoard3DCornerPositions, _leftRotationVectors, _leftTranslationVectors);
+	const ReprojectionErrors& _rightErrors = mRightHelper.calculateReprojectionErrors(allChessBoard3DCornerPositions, _rightRotationVectors, _rightTranslationVectors);
+	std::cout << fmt::format("Left Re-projection Error={:.5f} (largest corner error {:.5f}), Right Re-projection Error={:.5f} (largest corner error {:.5f})\n", 
+	                         _leftErrors.rmsError, _leftErrors.maxError, _rightErrors.rmsError, _rightErrors.maxError);
+}
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+
 }; // end namespace RCamera.
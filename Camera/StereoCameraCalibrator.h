@@ -28,6 +28,10 @@ public:
 	void getParameters(std::vector<double>& intrinsicLeft, std::vector<double>& distortionLeft, std::vector<double>& intrinsicRight, std::vector<double>& distortionRight);
 	void getDebugParameters(double& leftCoverage, double& leftRmsError, double& rightCoverage, double& rightRmsError);
 
+	// The number of accepted views covering each cell of the coverage grids, empty if CoverageGridWidth is 0.
+	inline const cv::Mat& leftCoverageGrid()  const {return mLeftHelper.mCoverageGrid; }
+	inline const cv::Mat& rightCoverageGrid() const {return mRightHelper.mCoverageGrid; }
+
 
 	#if defined(RVISIONLIB_HAVE_QT)
 		inline QImage leftDisplayImage()  const {return mLeftHelper.displayImage(); }
@@ -38,7 +42,9 @@ public:
 private:
 	
 
-	bool _calibrateCamera();
+	bool   _calibrateCamera();
+	double _calibrateIntrinsics(CameraCalibratorHelper* helper, const std::vector<std::vector<cv::Point3f>>& allChessBoard3DCornerPositions, int calibrationFlag) const;
+	void   _calculateReprojectionErrors(const std::vector<std::vector<cv::Point3f>>& allChessBoard3DCornerPositions);
 
 
 private:
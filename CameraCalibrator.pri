@@ -18,7 +18,14 @@ HEADERS += ./qcustomplot.h \
     ./Camera/CalibratorConfiguration.h \
     ./Camera/CameraCalibratorHelper.h \
     ./Camera/MonoCameraCalibrator.h \
-    ./Camera/StereoCameraCalibrator.h
+    ./Camera/StereoCameraCalibrator.h \
+    ./Camera/DetectionCache.h \
+    ./Camera/CalibrationBenchmark.h \
+    ./Camera/SparseCalibrationSolver.h \
+    ./Camera/CalibrationExecutor.h \
+    ./Camera/FisheyeCameraCalibrator.h \
+    ./Camera/MultiCameraCalibrator.h \
+    ./Camera/DisplayBufferPool.h
 SOURCES += ./Camera.cpp \
     ./GraphicsSceneClass.cpp \
     ./GraphicsViewZoom.cpp \
@@ -30,7 +37,14 @@ SOURCES += ./Camera.cpp \
     ./Camera/CalibratorConfiguration.cpp \
     ./Camera/CameraCalibratorHelper.cpp \
     ./Camera/MonoCameraCalibrator.cpp \
-    ./Camera/StereoCameraCalibrator.cpp
+    ./Camera/StereoCameraCalibrator.cpp \
+    ./Camera/DetectionCache.cpp \
+    ./Camera/CalibrationBenchmark.cpp \
+    ./Camera/SparseCalibrationSolver.cpp \
+    ./Camera/CalibrationExecutor.cpp \
+    ./Camera/FisheyeCameraCalibrator.cpp \
+    ./Camera/MultiCameraCalibrator.cpp \
+    ./Camera/DisplayBufferPool.cpp
 FORMS += ./MainWindow.ui
 RESOURCES += CameraCalibrator.qrc \
     loader.qrc
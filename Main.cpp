@@ -1,9 +1,111 @@
 
 #include "MainWindow.h"
+#include "Camera/CalibrationBenchmark.h"
 #include <QtWidgets/QApplication>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+/* Loads the optional configuration file passed after the benchmark flag. */
+static bool loadBenchmarkConfiguration(int argc, char *argv[], RCamera::CalibratorConfiguration &config)
+{
+    if (argc > 2)
+    {
+        std::string error;
+        if (!config.loadConfiguration(std::string(argv[2]), &error))
+        {
+            std::cerr << "Failed to load configuration: " << error << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Saves the benchmark report to the optional file name passed after the configuration file. */
+static void saveBenchmarkReport(int argc, char *argv[], const std::string &defaultFileName, const nlohmann::json &report)
+{
+    const std::string reportFileName = argc > 3 ? argv[3] : defaultFileName;
+    std::ofstream file(reportFileName);
+    file << report.dump(2);
+    std::cout << "Report saved to " << reportFileName << std::endl;
+}
+
+/* Benchmarks the chessboard detectors on synthetic images without opening the UI.
+   Usage: CameraCalibrator --benchmark-detectors [configuration.json] [report.json] */
+static int benchmarkDetectors(int argc, char *argv[])
+{
+    RCamera::CalibratorConfiguration config;
+    if (!loadBenchmarkConfiguration(argc, argv, config))
+    {
+        return 1;
+    }
+
+    const int numImages = 100;
+    const cv::Size imageSize(1280, 960);
+    RCamera::CalibrationBenchmark benchmark(config);
+    benchmark.createImages(numImages, imageSize);
+
+    nlohmann::json report;
+    report["BoardWidth"] = config.boardWidth();
+    report["BoardHeight"] = config.boardHeight();
+    report["ImageWidth"] = imageSize.width;
+    report["ImageHeight"] = imageSize.height;
+    report["Detectors"] = benchmark.benchmarkDetectorBackends();
+    saveBenchmarkReport(argc, argv, "DetectorBenchmark.json", report);
+    return 0;
+}
+
+/* Benchmarks the calibration solvers on synthetic views from 10 to 1000 views without opening the UI.
+   Usage: CameraCalibrator --benchmark-solvers [configuration.json] [report.json] */
+static int benchmarkSolvers(int argc, char *argv[])
+{
+    RCamera::CalibratorConfiguration config;
+    if (!loadBenchmarkConfiguration(argc, argv, config))
+    {
+        return 1;
+    }
+
+    RCamera::CalibrationBenchmark benchmark(config);
+    nlohmann::json report;
+    report["BoardWidth"] = config.boardWidth();
+    report["BoardHeight"] = config.boardHeight();
+    report["Solvers"] = benchmark.benchmarkCalibrationSolvers({10, 30, 100, 300, 1000});
+    saveBenchmarkReport(argc, argv, "SolverBenchmark.json", report);
+    return 0;
+}
+
+/* Benchmarks the display image kernel at 1, 5 and 20 megapixels without opening the UI.
+   Usage: CameraCalibrator --benchmark-display [configuration.json] [report.json] */
+static int benchmarkDisplay(int argc, char *argv[])
+{
+    RCamera::CalibratorConfiguration config;
+    if (!loadBenchmarkConfiguration(argc, argv, config))
+    {
+        return 1;
+    }
+
+    RCamera::CalibrationBenchmark benchmark(config);
+    nlohmann::json report;
+    report["DisplayImage"] = benchmark.benchmarkDisplayImage({cv::Size(1280, 800), cv::Size(2592, 1944), cv::Size(5472, 3648)});
+    saveBenchmarkReport(argc, argv, "DisplayBenchmark.json", report);
+    return 0;
+}
 
 int main(int argc, char *argv[])
 {
+    if (argc > 1 && std::strcmp(argv[1], "--benchmark-detectors") == 0)
+    {
+        return benchmarkDetectors(argc, argv);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--benchmark-solvers") == 0)
+    {
+        return benchmarkSolvers(argc, argv);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--benchmark-display") == 0)
+    {
+        return benchmarkDisplay(argc, argv);
+    }
+
     QApplication a(argc, argv);
     MainWindow w;
     w.show();
@@ -102,7 +102,8 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent)
     connect(this, SIGNAL(obtainImagesPixListThread(QStringList)), worker, SLOT(obtainImagesPixList(QStringList)));
     connect(worker, SIGNAL(sendImagesPixList(QList<QPixmap>)), this, SLOT(obtainOrigImages(QList<QPixmap>)));   
     connect(this, SIGNAL(monoCalibrationTestThread(QStringList, RCamera::CalibratorConfiguration)), worker, SLOT(monoCalibrationTest(QStringList, RCamera::CalibratorConfiguration)));
-    connect(worker, SIGNAL(sendCalibratedImages(QList<QPixmap>, QList<QString>, QList<QString>)), this, SLOT(obtainCalibratedImages(QList<QPixmap>, QList<QString>, QList<QString>)));
+    connect(worker, SIGNAL(sendCalibratedImage(QImage, QString, QString)), this, SLOT(obtainCalibratedImage(QImage, QString, QString)));
+    connect(worker, SIGNAL(sendCalibrationFinished()), this, SLOT(onCalibrationFinished()));
     connect(worker, SIGNAL(sendLogMsg(QString)), this, SLOT(addLogMsg(QString)));
     connect(worker, SIGNAL(startExtractCamParams(std::vector<double>, std::vector<double>, double, double)), this, SLOT(obtainCameraParams(std::vector<double>, std::vector<double>, double, double)));
 
@@ -208,6 +209,7 @@ void MainWindow::loadConfiguration()
     mCalibFixK3CB->setChecked(mCalibratorConfiguration.calibFixK3());
     mCalibFixK4CB->setChecked(mCalibratorConfiguration.calibFixK4());
     mCalibFixK5CB->setChecked(mCalibratorConfiguration.calibFixK5());
+    mCameraModelCMB->setCurrentIndex(static_cast<int>(mCalibratorConfiguration.cameraModel()));
 }
 
 QString MainWindow::getLogTime()
@@ -311,6 +313,7 @@ void MainWindow::saveUserConfigurations()
     mCalibratorConfiguration.setCalibFixK3(mCalibFixK3CB->isChecked());
     mCalibratorConfiguration.setCalibFixK4(mCalibFixK4CB->isChecked());
     mCalibratorConfiguration.setCalibFixK5(mCalibFixK5CB->isChecked());
+    mCalibratorConfiguration.setCameraModel(static_cast<RCamera::CameraModel>(mCameraModelCMB->currentIndex()));
     addLogMsg("INFO Successfully saved all camera calibrator configuations in CalibratorConfiguration class");
 }
 
@@ -784,20 +787,16 @@ void MainWindow::onCalibPicMultiViewButtonClicked()
     displayCalibratedImagesMultiView(calibratedImages);
 }
 
-void MainWindow::obtainCalibratedImages(QList<QPixmap> PixList, QList<QString> CoverageList, QList<QString> RMSErrorList)
+void MainWindow::obtainCalibratedImage(QImage Image, QString Coverage, QString RMSError)
 {
-    foreach(QPixmap pix, PixList) {
-        calibratedImages.append(pix);
-    }
-
-    foreach(QString coverage, CoverageList) {
-        coverageParams.append(coverage);
-    }
-
-    foreach(QString rmsError, RMSErrorList) {
-        rmsValList.append(rmsError);
-    }
+    // pixmaps belong to the gui thread, so the image is converted here and its display buffer goes back to the pool
+    calibratedImages.append(QPixmap::fromImage(Image));
+    coverageParams.append(Coverage);
+    rmsValList.append(RMSError);
+}
 
+void MainWindow::onCalibrationFinished()
+{
     // set graphics view to default size
     //calibPicGraphicViewZoom->setDefaultSize();
     
@@ -48,7 +48,8 @@ private slots:
     void onOrigPicMultiViewButtonClicked(); /* invoked when user clicks the 'MultiView' button to view images in multiple view mode */
     void displayOrigImagesMultiView(QList<QPixmap> PixList); /* to display original images in multi view mode */
     void obtainOrigImages(QList<QPixmap> PixList); /* obtain list of orig images in pixmap from worker thread */
-    void obtainCalibratedImages(QList<QPixmap> PixList, QList<QString> CoverageParams, QList<QString> RMSErrorList); /* obtain list of calibrated images in pixmap from worker thread */
+    void obtainCalibratedImage(QImage Image, QString Coverage, QString RMSError); /* obtain a calibrated image from worker thread and convert it to pixmap */
+    void onCalibrationFinished(); /* invoked when worker thread has sent all calibrated images, to display them */
     void displayCalibImagesSingleView(); /* to display calibrated images in single view mode */
     void displayCalibratedImagesMultiView(QList<QPixmap> PixList); /* to display calibrated images in multi view mode */
     void onCalibPicSingleViewButtonClicked(); /* invoked when user clicks the 'Single View' button to view calibrated images in single view mode */
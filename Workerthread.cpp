@@ -7,8 +7,14 @@
 #include <QPixmap>
 #include "Camera/CalibratorConfiguration.h"
 #include "Camera/MonoCameraCalibrator.h"
+#include "Camera/FisheyeCameraCalibrator.h"
 #include <opencv2/imgcodecs.hpp>
 #include "fmt/format.h"
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
 
 Workerthread::Workerthread(QObject* parent) : QObject(parent)
 {
@@ -33,39 +39,157 @@ void Workerthread::obtainImagesPixList(QStringList matChessPics)
 
 void Workerthread::monoCalibrationTest(QStringList matChessPics, RCamera::CalibratorConfiguration _config)
 {
-    qDebug() << "Starting MonoCalibration";
-    RCamera::MonoCameraCalibrator _calibrator(_config);
+    // wide-angle lenses are fitted with the fisheye model
+    if (_config.cameraModel() == RCamera::CameraModel::Fisheye)
+    {
+        qDebug() << "Starting FisheyeCalibration";
+        emit(sendLogMsg("INFO Calibrating with the fisheye camera model"));
+        RCamera::FisheyeCameraCalibrator _calibrator(_config);
+        runCalibration(_calibrator, matChessPics, _config);
+    }
+    else
+    {
+        qDebug() << "Starting MonoCalibration";
+        RCamera::MonoCameraCalibrator _calibrator(_config);
+        runCalibration(_calibrator, matChessPics, _config);
+    }
+}
 
+template <class Calibrator>
+void Workerthread::runCalibration(Calibrator& _calibrator, const QStringList& matChessPics, const RCamera::CalibratorConfiguration& _config)
+{
     int imageIndex = 0; /* to store the image index number */
-    QList<QPixmap> PixList; /* to store calibrated images */
     std::vector<double> intrinsic; /* to store intrinsic parameters */
     std::vector<double> distortion; /* to store distortion parameters */
-    QList<QString> CoverageParams; /* to store respective calibrated images coverage value */
-    QList<QString> RMSErrorList; /* to store respective calibrated images RMS Error value */
+
+    // decode images and find chessboard corners on a pool of threads, the results are committed below in file order
+    const int numImages = matChessPics.size();
+    int numThreads = _config.numDetectionThreads() > 0 ? _config.numDetectionThreads() : int(std::thread::hardware_concurrency());
+    numThreads = std::max(1, std::min(numThreads, numImages));
+    const int maxImagesInFlight = 2 * numThreads; /* limits the number of decoded images held in memory */
+
+    std::vector<DetectedImage> detectedImages(numImages);
+    std::mutex detectionMutex;
+    std::condition_variable detectionCondition;
+    int nextImageToDetect = 0;
+    int nextImageToCommit = 0;
+
+    auto detectionWorker = [&]()
+    {
+        while (true)
+        {
+            int index = 0;
+            {
+                std::unique_lock<std::mutex> lock(detectionMutex);
+                detectionCondition.wait(lock, [&]() { return nextImageToDetect >= numImages || nextImageToDetect < nextImageToCommit + maxImagesInFlight; });
+                if (nextImageToDetect >= numImages)
+                {
+                    return;
+                }
+                index = nextImageToDetect++;
+            }
+
+            DetectedImage detected;
+            cv::Mat image = cv::imread(matChessPics.at(index).toStdString(), cv::IMREAD_GRAYSCALE);
+            if (!image.empty())
+            {
+                detected.detection = _calibrator.detect(image.data, image.cols, image.rows, 1, int(image.step[0]));
+            }
+            detected.isDone = true;
+
+            {
+                std::lock_guard<std::mutex> lock(detectionMutex);
+                detectedImages[index] = std::move(detected);
+            }
+            detectionCondition.notify_all();
+        }
+    };
+
+    // with background calibration, the results of batches are reported from the calibration thread
+    if constexpr (std::is_same<Calibrator, RCamera::MonoCameraCalibrator>::value)
+    {
+        if (_config.backgroundCalibration())
+        {
+            _calibrator.setCalibrationCallback([this](RCamera::CameraCalibrationStatus status, const RCamera::MonoCameraCalibrator& result)
+            {
+                if (status != RCamera::CameraCalibrationStatus::Calibrated)
+                {
+                    emit(sendLogMsg("INFO Background calibration finished above the maximum RMS error"));
+                    return;
+                }
+
+                emit(sendLogMsg("INFO Camera calibrated in the background. Saving parameters to file."));
+                result.saveParametersToFile(std::string("CameraParameters.json"));
+
+                std::vector<double> intrinsic;
+                std::vector<double> distortion;
+                double coverage = 0;
+                double rmsError = 0;
+                result.getParameters(intrinsic, distortion);
+                result.getDebugParameters(coverage, rmsError);
+                emit(startExtractCamParams(intrinsic, distortion, coverage, rmsError));
+            });
+        }
+    }
+
+    std::vector<std::thread> detectionThreads;
+    for (int i = 0; i < numThreads; i++)
+    {
+        detectionThreads.emplace_back(detectionWorker);
+    }
+    emit(sendLogMsg("INFO Finding chessboard corners using " + QString::number(numThreads) + " threads"));
 
     for (const auto& it : matChessPics)
     {
+        // wait for the next image in file order
+        DetectedImage detected;
+        {
+            std::unique_lock<std::mutex> lock(detectionMutex);
+            detectionCondition.wait(lock, [&]() { return detectedImages[imageIndex].isDone; });
+            detected = std::move(detectedImages[imageIndex]);
+            nextImageToCommit = imageIndex + 1;
+        }
+        detectionCondition.notify_all();
+
         imageIndex += 1;
         emit(sendLogMsg("INFO Found file: " + it));
         qDebug() << "Found file: " << it;
         
-        // loads image from specified file
-        cv::Mat _image = cv::imread(it.toStdString(), cv::IMREAD_GRAYSCALE);
-        
-        if (!_image.empty())
+        // image loaded from specified file
+        if (!detected.detection.image.empty())
         {
-            int _width = _image.cols;
-            int _height = _image.rows;
-            unsigned char* _imageData = _image.data;
-            int _rowLength = int(_image.step[0]);
             double _coverage = 0;
             double _rmsError = 0;
 
             emit(sendLogMsg("INFO File: " + it + "- Processing Image (Accept) " + QString::number(_calibrator.numAcceptedImages())));
             qDebug() << "Processing image (Accept) " << _calibrator.numAcceptedImages();
             
+            // log the time spent on each pyramid level to help tuning the detection
+            QStringList levelTimes;
+            for (double levelTimeMS : detected.detection.levelTimesMS)
+            {
+                levelTimes.append(QString::number(levelTimeMS, 'f', 1));
+            }
+            if (detected.detection.isCached)
+            {
+                emit(sendLogMsg("INFO File: " + it + "- Chessboard corners loaded from detection cache in " + QString::number(detected.detection.detectionTimeMS, 'f', 1) + " ms"));
+            }
+            else
+            {
+                emit(sendLogMsg("INFO File: " + it + "- Detection time " + QString::number(detected.detection.detectionTimeMS, 'f', 1) + 
+                                " ms (pyramid levels " + levelTimes.join(", ") + " ms)"));
+            }
+
             // get calibration status
-            RCamera::CameraCalibrationStatus _status = _calibrator.setImage(_imageData, _width, _height, 1, _rowLength);
+            const int numDroppedViews = _calibrator.numDroppedViews();
+            RCamera::CameraCalibrationStatus _status = _calibrator.addDetection(detected.detection);
+
+            // calibration may drop views with outlying re-projection errors
+            if (_calibrator.numDroppedViews() > numDroppedViews)
+            {
+                emit(sendLogMsg("INFO File: " + it + "- Dropped " + QString::number(_calibrator.numDroppedViews() - numDroppedViews) + 
+                                " views with outlying re-projection errors"));
+            }
 
             // do respective actions wrt status
             switch (_status)
@@ -78,15 +202,11 @@ void Workerthread::monoCalibrationTest(QStringList matChessPics, RCamera::Calibr
             }
             case RCamera::CameraCalibrationStatus::ImageAccepted:
             {
-                // obtain image and append to list 
-                QImage image = _calibrator.displayImage();
-                QPixmap pix = QPixmap::fromImage(image);
-                PixList.append(QPixmap::fromImage(image));
-                
                 // obtain coverage and rms error values 
                 _calibrator.getDebugParameters(_coverage, _rmsError);
-                CoverageParams.append(QString::number(_coverage));
-                RMSErrorList.append(QString::number(_rmsError));
+
+                // send image right away, holding on to it until the end would keep every display buffer out of the pool
+                emit(sendCalibratedImage(_calibrator.displayImage(), QString::number(_coverage), QString::number(_rmsError)));
                 emit(sendLogMsg("INFO File: " + it + "- Image accepted. Coverage is  " + QString::number(_coverage)));
                 qDebug() << "Image accepted. Coverage is: " << _coverage;
                 break;
@@ -97,6 +217,18 @@ void Workerthread::monoCalibrationTest(QStringList matChessPics, RCamera::Calibr
                 qDebug() << "Image rejected";
                 break;
             }
+            case RCamera::CameraCalibrationStatus::ImageBlurred:
+            {
+                emit(sendLogMsg("INFO File: " + it + "- Image rejected, too blurred. Sharpness is " + QString::number(detected.detection.sharpness, 'f', 1)));
+                qDebug() << "Image rejected, too blurred";
+                break;
+            }
+            case RCamera::CameraCalibrationStatus::ImageOverexposed:
+            {
+                emit(sendLogMsg("INFO File: " + it + "- Image rejected, overexposed. Saturated fraction is " + QString::number(detected.detection.saturation, 'f', 3)));
+                qDebug() << "Image rejected, overexposed";
+                break;
+            }
             case RCamera::CameraCalibrationStatus::Calibrated:
             {
                 // save camera parameters
@@ -132,8 +264,27 @@ void Workerthread::monoCalibrationTest(QStringList matChessPics, RCamera::Calibr
         }
     }
 
-    // send list of calibrated images back to main thread
+    for (auto& thread : detectionThreads)
+    {
+        thread.join();
+    }
+
+    // wait for the calibration of the last batch
+    if constexpr (std::is_same<Calibrator, RCamera::MonoCameraCalibrator>::value)
+    {
+        _calibrator.waitForBackgroundCalibration();
+    }
+
+    if (!_config.detectionCacheDirectory().empty())
+    {
+        int numCacheHits = 0;
+        int numCacheMisses = 0;
+        _calibrator.getDetectionCacheStatistics(numCacheHits, numCacheMisses);
+        emit(sendLogMsg("INFO Detection cache: " + QString::number(numCacheHits) + " hits, " + QString::number(numCacheMisses) + " misses"));
+    }
+
+    // calibrated images have all been sent, let main thread display them
     emit(sendLogMsg("INFO End of MonoCalibrationTest. Redirecting to main thread."));
     qDebug() << "End of MonoCalibrationTest";
-    emit sendCalibratedImages(PixList, CoverageParams, RMSErrorList);
+    emit sendCalibrationFinished();
 }
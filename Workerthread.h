@@ -5,6 +5,7 @@
 #include <QThread>
 #include <QMutex>
 #include <vector>
+#include <QImage>
 #include <QPixmap>
 #include "Camera/CalibratorConfiguration.h"
 #include "Camera/MonoCameraCalibrator.h"
@@ -23,12 +24,20 @@ public slots:
 
 signals:
     void sendImagesPixList(QList<QPixmap> PixList); /* sends list of original images in pixmap back to main thread to be displayed in the ui */
-    void sendCalibratedImages(QList<QPixmap> PixList, QList<QString> CoverageParams, QList<QString> RMSErrorList); /* sends list of calibrated images in pixmap to main thread to be displayed in the ui */
+    void sendCalibratedImage(QImage Image, QString Coverage, QString RMSError); /* sends each accepted image to main thread as it is produced, so its display buffer is released once the main thread has converted it */
+    void sendCalibrationFinished(); /* tells main thread that all images have been sent and can be displayed in the ui */
     void sendLogMsg(QString msg); /* sends log messages to be displayed in the debug log */
     void startExtractCamParams(std::vector<double> intrinsic, std::vector<double> distortion, double _coverage, double _rmsError); /* sends generated camera parameters if any to be displayed in the ui */
 
 private:
-     
+    template <class Calibrator>
+    void runCalibration(Calibrator& _calibrator, const QStringList& matChessPics, const RCamera::CalibratorConfiguration& _config); /* runs the calibration algorithm with a mono or fisheye calibrator */
+
+    struct DetectedImage /* chessboard detection of an image decoded by a detection thread */
+    {
+        RCamera::ChessboardDetection detection;
+        bool isDone = false;
+    };
 };
 
 #endif // WORKERTHREAD_H